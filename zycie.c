@@ -5,9 +5,28 @@ Autor: Michał Mnich
 Wersja: 3.0.0
 Data: 10 stycznia 2023  */
 
+#define _POSIX_C_SOURCE 200809L // Wątki, odwzorowanie plików w pamięci, 
+                                // procesy, gniazda i zegary.
+
 #include <assert.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "zycie.h"
 
 #ifndef WIERSZE
 #define WIERSZE 22
@@ -28,17 +47,6 @@ Data: 10 stycznia 2023  */
 #define ODWIEDZONA_ZYWA 53 // Żywa komórka, która została już odwiedzona.
 #define ODWIEDZONA_MARTWA 54 // Martwa komórka, która została już odwiedzona.
 
-/*  Parametry opisujące wymiary bieżącej planszy.  */
-struct wymiary {
-    int m; // Liczba wierszy.
-    int n; // Liczba kolumn.
-    int min_w; // Najmniejszy indeks wiersza.
-    int min_k; // Najmniejszy indeks kolumny.
-    int max_w; // Największy indeks wiersza.
-    int max_k; // Największy indeks kolumny.
-};
-typedef struct wymiary Twymiary;
-
 /*  Parametry opisujące bieżące okno (lewy górny róg).  */
 struct okno {
     int w; // Wiersz, w którym zaczyna się okno.
@@ -46,629 +54,6520 @@ struct okno {
 };
 typedef struct okno Tokno;
 
-/*  Lista zawierająca numery kolumn.  */
-struct kolumny {
-    int k;
-    struct kolumny* nast_k;
+/*  Prostokąt od wiersza 'w1' i kolumny 'k1' do wiersza 'w2' i kolumny 'k2'
+    włącznie.  */
+struct prostokat {
+    int w1; // Górny wiersz.
+    int k1; // Lewa kolumna.
+    int w2; // Dolny wiersz.
+    int k2; // Prawa kolumna.
+};
+typedef struct prostokat Tprostokat;
+
+/*  Zbiór żywych komórek zapisany w ciągłych tablicach. Numery niepustych
+    wierszy leżą rosnąco w tablicy 'w', a kolumny wiersza 'w[i]' leżą rosnąco
+    w 'k[pocz[i]]', ..., 'k[pocz[i + 1] - 1]'.  */
+struct zywe {
+    int ile_w; // Liczba niepustych wierszy.
+    int poj_w; // Pojemność tablicy 'w' (tablica 'pocz' ma o jeden więcej).
+    int poj_k; // Pojemność tablicy 'k'.
+    int* w; // Numery wierszy.
+    int* pocz; // Początki wierszy w tablicy 'k'.
+    int* k; // Numery kolumn.
+    long long przydzialy; // Liczba przydziałów pamięci na tablice.
+};
+typedef struct zywe Tzywe;
+
+/*  Bufory, do których trafiają kolejne generacje. Są powiększane tylko
+    wtedy, gdy kolejna generacja się w nich nie mieści.  */
+struct bufory {
+    Tzywe gora; // Kandydaci z wierszy nad żywymi wierszami.
+    Tzywe srodek; // Kandydaci z żywych wierszy.
+    Tzywe dol; // Kandydaci z wierszy pod żywymi wierszami.
+    Tzywe nast; // Następna generacja.
+};
+typedef struct bufory Tbufory;
+
+#define SILNIK_LISTA 0 // Lista żywych komórek i plansza znaków.
+#define SILNIK_BITY 1 // Plansza upakowana bitowo, 64 komórki w słowie.
+#define SILNIK_HASHLIFE 2 // Drzewo czwórkowe z zapamiętanymi wynikami.
+#define SILNIK_OBSZARY 3 // Obszary bitowe liczone tylko tam, gdzie są zmiany.
+#define SILNIK_AUTO 4 // Lista albo plansza bitowa, zależnie od gęstości.
+
+/*  Tryb automatyczny przechodzi na silnik bitowy, gdy żywa jest co 
+    najmniej jedna na 'PROG_BITOW' komórek planszy bitowej (wraz z jej 
+    marginesami), i wraca do listy, gdy żywa jest mniej niż jedna na 
+    'PROG_LISTY' komórek. Generacja silnikiem bitowym kosztuje ułamek 
+    nanosekundy na komórkę planszy, a listowym kilkadziesiąt i więcej na 
+    żywą komórkę.  */
+#define PROG_BITOW 512
+#define PROG_LISTY 2048
+#define PORCJA_AUTO 16 // Co tyle generacji sprawdzana jest gęstość.
+
+/*  Reguła gry zapisana jako maska bitowa: bit 'n' oznacza narodziny 
+    martwej komórki z 'n' żywymi sąsiadami, a bit 'PRZEZYCIE + n' przeżycie
+    żywej komórki z 'n' żywymi sąsiadami.  */
+#define PRZEZYCIE 9 // Przesunięcie bitów przeżycia w masce reguły.
+#define REGULA_CONWAY /* B3/S23 */ \
+    ((1 << 3) | (1 << (PRZEZYCIE + 2)) | (1 << (PRZEZYCIE + 3)))
+#define REGULA_HIGHLIFE /* B36/S23 */ (REGULA_CONWAY | (1 << 6))
+#define REGULA_DZIEN_I_NOC /* B3678/S34678 */ \
+    ((1 << 3) | (1 << 6) | (1 << 7) | (1 << 8) | (1 << (PRZEZYCIE + 3)) \
+     | (1 << (PRZEZYCIE + 4)) | (1 << (PRZEZYCIE + 6)) \
+     | (1 << (PRZEZYCIE + 7)) | (1 << (PRZEZYCIE + 8)))
+#define REGULA_NASIONA /* B2/S */ (1 << 2)
+
+/*  Funkcje, które muszą zostać wplecione w miejsce wywołania, aby stałe 
+    argumenty (na przykład reguła) upraszczały ich kod.  */
+#if defined(__GNUC__)
+#define WPLATANA __attribute__((always_inline)) static inline
+#else
+#define WPLATANA static inline
+#endif
+
+/*  Funkcje liczące generację silnikiem bitowym kompilowane także w wersji 
+    dla procesorów z AVX2, wybieranej przy uruchomieniu.  */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define KLONY_AVX2 __attribute__((target_clones("avx2", "default")))
+#else
+#define KLONY_AVX2
+#endif
+
+/*  Funkcje spoza interfejsu z pliku zycie.h. W bibliotece są widoczne
+    tylko w jej własnym pliku, aby ich nazwy nie zderzały się z nazwami 
+    w programie, do którego jest dołączana. Funkcje potrzebne tylko 
+    programowi (polecenia, opcje, tryb wsadowy) zostają w niej 
+    nieużywane.  */
+#if defined(ZYCIE_BIBLIOTEKA) && defined(__GNUC__)
+#define WEWNETRZNA __attribute__((unused)) static
+#elif defined(ZYCIE_BIBLIOTEKA)
+#define WEWNETRZNA static
+#else
+#define WEWNETRZNA
+#endif
+
+#define MARGINES_BITOW 62 // Margines martwych komórek wokół planszy bitowej.
+#define PRZEGLAD_BITOW 64 // Co ile generacji sprawdzać, czy plansza bitowa
+                          // nie jest za duża.
+#define LUZ_BITOW 4 // Ile razy plansza bitowa może być większa od 
+                    // potrzebnej, zanim zostanie zmniejszona.
+
+/*  Słowa przetwarzane naraz przez silnik bitowy. Przy kompilatorze GNU są
+    to wektory czterech słów, z których kompilator robi rejestry AVX2 lub
+    pary rejestrów SSE2, a w pozostałych przypadkach pojedyncze słowa.  */
+#if defined(__GNUC__)
+#define SZEROKOSC_WEKTORA 4
+typedef uint64_t Twektor __attribute__((vector_size(32)));
+#else
+#define SZEROKOSC_WEKTORA 1
+typedef uint64_t Twektor;
+#endif
+
+/*  Plansza upakowana bitowo. Wiersze leżą jeden za drugim w jednej
+    tablicy i każdy z nich ma 'slowa' słów. Bit 'b' słowa 's' w wierszu 'r'
+    to komórka w wierszu 'min_w + r' i kolumnie 'min_k + 64 * s + b'. 
+    Pierwszy i ostatni wiersz oraz pierwsze i ostatnie słowo każdego wiersza
+    są zawsze puste. Wyjątkiem jest plansza o stałych wymiarach: jej 
+    komórki zajmują wiersze od 0 do 'wysokosc' - 1 i kolumny od 0 do 
+    'szerokosc' - 1, a na torusie przed każdym krokiem otaczający je pas 
+    (wiersze 0 i 'wysokosc' + 1 oraz kolumny -1 i 'szerokosc') dostaje
+    kopię przeciwległego brzegu.  */
+struct bity {
+    int wiersze; // Liczba wierszy.
+    int slowa; // Liczba słów w wierszu.
+    int min_w; // Numer wiersza nr 0.
+    int min_k; // Numer kolumny bitu nr 0 w słowie nr 0.
+    uint64_t* akt; // Bieżąca generacja.
+    uint64_t* nast; // Bufor na następną generację.
+    int wysokosc; // Liczba wierszy planszy o stałych wymiarach lub 0.
+    int szerokosc; // Liczba kolumn planszy o stałych wymiarach lub 0.
+    int torus; // Czy brzegi planszy o stałych wymiarach są sklejone.
+    int do_przegladu; // Liczba generacji do sprawdzenia rozmiaru planszy.
+};
+typedef struct bity Tbity;
+
+#define BRAK UINT32_MAX // Brak węzła drzewa HashLife.
+#define MAKS_POZIOM 62 // Największy poziom węzła drzewa HashLife.
+#define PAMIEC_HASHLIFE 1024 // Domyślny limit pamięci na węzły w MB.
+
+/*  Węzeł drzewa czwórkowego HashLife. Węzeł poziomu 'k' to kwadrat o boku 
+    2^k złożony z czterech węzłów poziomu 'k - 1'. Węzły poziomu 0 to 
+    martwa (numer 0) i żywa (numer 1) komórka. Każdy kwadrat ma dokładnie
+    jeden węzeł, więc powtarzające się fragmenty wzoru są współdzielone.  */
+struct wezel {
+    uint32_t lg; // Lewa górna ćwiartka.
+    uint32_t pg; // Prawa górna ćwiartka.
+    uint32_t ld; // Lewa dolna ćwiartka.
+    uint32_t pd; // Prawa dolna ćwiartka.
+    uint32_t nast_h; // Następny węzeł w kubełku lub na liście wolnych.
+    uint32_t wynik; // Środek po 2^(k - 2) generacjach lub BRAK.
+    uint32_t wynik_j; // Środek po 2^krok_j generacjach.
+    int8_t poziom; // Poziom węzła lub -1 dla wolnego miejsca.
+    int8_t krok_j; // Wykładnik dla 'wynik_j' lub -1, gdy go nie ma.
+    uint8_t znacznik; // Znacznik osiągalności przy odśmiecaniu.
+};
+typedef struct wezel Twezel;
+
+/*  Drzewo HashLife wraz z tablicą wszystkich węzłów.  */
+struct hashlife {
+    Twezel* wezly; // Tablica węzłów.
+    uint32_t ile; // Liczba wykorzystanych miejsc w tablicy węzłów.
+    uint32_t poj; // Pojemność tablicy węzłów.
+    uint32_t zajete; // Liczba węzłów (bez wolnych miejsc).
+    uint32_t limit; // Liczba węzłów, po której zaczyna się odśmiecanie.
+    uint32_t wolne; // Lista wolnych miejsc.
+    uint32_t* kubelki; // Początki list węzłów o tym samym skrócie.
+    uint32_t maska; // Liczba kubełków pomniejszona o jeden.
+    uint32_t puste[MAKS_POZIOM + 1]; // Puste węzły kolejnych poziomów.
+    uint32_t* stos; // Węzły chronione przed odśmiecaniem w trakcie obliczeń.
+    int ile_stos; // Liczba węzłów na stosie.
+    int poj_stos; // Pojemność stosu.
+    uint32_t korzen; // Korzeń drzewa.
+    long long min_w; // Wiersz lewego górnego rogu korzenia.
+    long long min_k; // Kolumna lewego górnego rogu korzenia.
+    long long odsmiecania; // Liczba odśmieceń.
+    uint8_t tabela[1 << 16]; // Środek 2 x 2 każdego kwadratu 4 x 4 po 
+                             // jednej generacji.
+};
+typedef struct hashlife Thashlife;
+
+/*  Węzeł drzewa HashLife leżący w pasie wierszy od kolumny 'k'.  */
+struct w_pasie {
+    uint32_t wezel;
+    long long k;
+};
+typedef struct w_pasie Tw_pasie;
+
+#define BOK_KAFELKA 64 // Bok kwadratowego kafelka planszy.
+
+/*  Kafelek planszy: kwadrat komórek, którego lewy górny róg leży 
+    w wierszu 'BOK_KAFELKA * w' i kolumnie 'BOK_KAFELKA * k'.  */
+struct kafelek {
+    int w; // Wiersz kafelka.
+    int k; // Kolumna kafelka.
+    int stempel; // Stempel ostatniego umieszczenia na nim żywej komórki.
+    char pola[BOK_KAFELKA][BOK_KAFELKA]; // Komórki.
+};
+typedef struct kafelek Tkafelek;
+
+/*  Miejsce w tablicy haszującej kafelków. Współrzędne są powtórzone, 
+    aby wyszukiwanie nie musiało sięgać do samych kafelków.  */
+struct miejsce {
+    int w; // Wiersz kafelka.
+    int k; // Kolumna kafelka.
+    Tkafelek* kafelek; // Kafelek lub NULL, jeśli miejsce jest wolne.
+};
+typedef struct miejsce Tmiejsce;
+
+/*  Plansza złożona z kafelków przechowywanych w tablicy haszującej.
+    Kafelki istnieją tylko tam, gdzie są żywe komórki, a wszystkie pola
+    poza nimi są martwe.  */
+struct plansza {
+    Tkafelek** kafelki; // Wszystkie kafelki.
+    int ile; // Liczba kafelków.
+    int poj; // Pojemność tablicy 'kafelki'.
+    Tmiejsce* indeks; // Tablica haszująca z kafelkami.
+    int maska; // Rozmiar tablicy haszującej pomniejszony o jeden.
+    Tkafelek* ostatni; // Ostatnio znaleziony kafelek.
+    int stempel; // Numer ostatniego umieszczenia żywych komórek.
+};
+typedef struct plansza Tplansza;
+
+/*  Kafelek planszy i kafelki wokół niego, wyszukiwane dopiero wtedy, gdy 
+    są potrzebne.  */
+struct otoczenie {
+    Tplansza* p; // Plansza.
+    int w; // Wiersz środkowego kafelka.
+    int k; // Kolumna środkowego kafelka.
+    Tkafelek* kafelki[3][3]; // Znalezione kafelki lub NULL, jeśli ich nie ma.
+    int znane; // Maska bitowa już wyszukanych kafelków.
+};
+typedef struct otoczenie Totoczenie;
+
+#define ROZNI_SIE_1 1 // Generacja obszaru różni się od poprzedniej.
+#define ROZNI_SIE_2 2 // Generacja obszaru różni się od tej sprzed dwóch.
+
+#define OBSZAR_USPIONY 0 // Otoczenie obszaru się nie zmieniło.
+#define OBSZAR_OKRES_2 1 // Otoczenie obszaru powtarza się co dwie generacje.
+#define OBSZAR_LICZONY 2 // Następna generacja obszaru jest liczona.
+
+/*  Obszar silnika obszarów: kwadrat komórek, którego lewy górny róg leży
+    w wierszu 'BOK_KAFELKA * w' i kolumnie 'BOK_KAFELKA * k'. Bit 'b' słowa
+    'r' generacji to komórka w wierszu 'BOK_KAFELKA * w + r' i kolumnie
+    'BOK_KAFELKA * k + b', więc bok kafelka musi wynosić 64. Obszar pamięta
+    dwie ostatnie generacje, a trzecie miejsce służy za bufor na następną.  */
+struct obszar {
+    int w; // Wiersz obszaru.
+    int k; // Kolumna obszaru.
+    int nr; // Położenie obszaru w tablicy wszystkich obszarów.
+    int akt; // Miejsce bieżącej generacji w tablicy 'stan'.
+    int poprz; // Miejsce poprzedniej generacji w tablicy 'stan'.
+    int zmiany; // Maska bitów ROZNI_SIE_1 i ROZNI_SIE_2.
+    int nowe_zmiany; // Maska zmian po policzeniu następnej generacji.
+    int decyzja; // Co dzieje się z obszarem w bieżącym kroku.
+    int runda; // Ostatni krok, w którym obszar był kandydatem.
+    uint64_t stan[3][BOK_KAFELKA]; // Generacje.
+};
+typedef struct obszar Tobszar;
+
+/*  Miejsce w tablicy haszującej obszarów.  */
+struct miejsce_obszaru {
+    int w; // Wiersz obszaru.
+    int k; // Kolumna obszaru.
+    Tobszar* obszar; // Obszar lub NULL, jeśli miejsce jest wolne.
+};
+typedef struct miejsce_obszaru Tmiejsce_obszaru;
+
+/*  Plansza silnika obszarów. Aktywne są obszary, które zmieniły się
+    w jednej z dwóch ostatnich generacji. Kolejna generacja jest liczona
+    tylko w nich i w ich sąsiadach, a reszta planszy (martwa, stała albo
+    o okresie 2) przechodzi do niej bez żadnej pracy. Obszarów nie ma
+    tam, gdzie od dwóch generacji nie ma żywych komórek.  */
+struct obszary {
+    Tobszar** obszary; // Wszystkie obszary.
+    int ile; // Liczba obszarów.
+    int poj; // Pojemność tablicy 'obszary'.
+    Tmiejsce_obszaru* indeks; // Tablica haszująca z obszarami.
+    int maska; // Rozmiar tablicy haszującej pomniejszony o jeden.
+    Tobszar** aktywne; // Aktywne obszary.
+    int ile_aktywnych; // Liczba aktywnych obszarów.
+    int poj_aktywnych; // Pojemność tablicy 'aktywne'.
+    Tobszar** kandydaci; // Obszary, które mogą się zmienić w tym kroku.
+    int ile_kandydatow; // Liczba kandydatów.
+    int poj_kandydatow; // Pojemność tablicy 'kandydaci'.
+    int runda; // Numer bieżącego kroku.
+    int niepewne; // Czy generacje sprzed wczytania wzoru są nieznane.
+    uint64_t puste[BOK_KAFELKA]; // Generacja nieistniejącego obszaru.
+};
+typedef struct obszary Tobszary;
+
+/*  Pasmo wierszy liczone przez jeden wątek. Pasma nie mają wspólnych 
+    danych, do których się pisze: każde czyta bieżącą generację (wraz
+    z wierszem nad i pod pasmem) i zapisuje swój kawałek następnej.  */
+struct pasmo {
+    Tzywe* zywe; // Bieżąca generacja.
+    int od_w; // Pierwszy wiersz pasma.
+    int do_w; // Wiersz tuż za pasmem.
+    int regula; // Reguła gry.
+    Tzywe wynik; // Żywe komórki pasma w następnej generacji.
+};
+typedef struct pasmo Tpasmo;
+
+struct pula;
+
+/*  Dane przekazywane wątkowi roboczemu.  */
+struct robotnik {
+    struct pula* pula; // Pula, do której należy wątek.
+    int nr; // Numer pasma liczonego przez wątek.
+};
+typedef struct robotnik Trobotnik;
+
+/*  Pula wątków liczących pasma. Wątek główny liczy pasmo zerowe, a każdy
+    z pozostałych 'ile - 1' wątków jedno z kolejnych.  */
+struct pula {
+    int ile; // Liczba pasm (i wątków, łącznie z głównym).
+    pthread_t* watki; // Wątki robocze.
+    Trobotnik* robotnicy; // Dane wątków roboczych.
+    Tpasmo* pasma; // Pasma.
+    pthread_mutex_t zamek; // Chroni pola poniżej.
+    pthread_cond_t start; // Sygnał rozpoczęcia nowej rundy.
+    pthread_cond_t gotowe; // Sygnał zakończenia wszystkich pasm.
+    int runda; // Numer bieżącej rundy.
+    int pozostalo; // Liczba pasm jeszcze liczonych w bieżącej rundzie.
+    int koniec; // Czy wątki mają się zakończyć.
+};
+typedef struct pula Tpula;
+
+#define PORCJA_PROCESOW 256 // Co ile generacji pasy procesów są wyrównywane.
+
+#define ZLECENIE_KONIEC 0 // Zakończenie procesu roboczego.
+#define ZLECENIE_PAS 1 // Przyjęcie nowego pasa.
+#define ZLECENIE_GENERACJE 2 // Policzenie kolejnych generacji pasa.
+#define ZLECENIE_WYROWNAJ 3 // Oddanie sąsiadom skrajnych wierszy pasa.
+#define ZLECENIE_PROSTOKAT 4 // Odesłanie komórek pasa leżących w prostokącie.
+
+/*  Zlecenie dla procesu roboczego. Żywe komórki nowego pasa są przesyłane
+    zaraz za zleceniem ZLECENIE_PAS.  */
+struct zlecenie {
+    int rodzaj; // Rodzaj zlecenia.
+    int regula; // Reguła gry (ZLECENIE_PAS).
+    int od_w; // Pierwszy wiersz pasa (ZLECENIE_PAS).
+    int do_w; // Wiersz tuż za pasem (ZLECENIE_PAS).
+    long long ile; // Liczba generacji (ZLECENIE_GENERACJE).
+    long long w_gore; // Komórki do oddania pasowi powyżej (ZLECENIE_WYROWNAJ).
+    long long w_dol; // Komórki do oddania pasowi poniżej (ZLECENIE_WYROWNAJ).
+    Tprostokat r; // Prostokąt (ZLECENIE_PROSTOKAT).
+};
+typedef struct zlecenie Tzlecenie;
+
+/*  Stan pasa odsyłany przez proces roboczy po każdym zleceniu, które 
+    zmienia pas. Proces główny nie trzyma komórek, więc z tych stanów 
+    bierze statystyki i na ich podstawie wyrównuje pasy.  */
+struct stan_pasa {
+    int od_w; // Pierwszy wiersz pasa.
+    int do_w; // Wiersz tuż za pasem.
+    int wiersze; // Liczba niepustych wierszy.
+    int pierwszy_w; // Pierwszy niepusty wiersz (gdy są żywe komórki).
+    int ostatni_w; // Ostatni niepusty wiersz.
+    int lewa_k; // Najmniejsza kolumna.
+    int prawa_k; // Największa kolumna.
+    long long zywe; // Liczba żywych komórek.
+};
+typedef struct stan_pasa Tstan_pasa;
+
+/*  Procesy robocze. Każdy trzyma między poleceniami pas kolejnych wierszy 
+    płaszczyzny i liczy go, a sąsiednie procesy po każdej generacji 
+    wymieniają się przez gniazda skrajnymi wierszami swoich pasów.  */
+struct procesy {
+    int ile; // Liczba procesów.
+    pid_t* pid; // Identyfikatory procesów.
+    int* gniazda; // Gniazda łączące z procesami.
+    Tstan_pasa* pasy; // Ostatnie stany pasów kolejnych procesów.
+};
+typedef struct procesy Tprocesy;
+
+#define ROZMIAR_CZYTNIKA (1 << 20) // Rozmiar bufora czytnika wejścia.
+
+/*  Czytnik wejścia: bufor wypełniany porcjami z pliku albo cała zawartość
+    pliku odwzorowana w pamięci.  */
+struct czytnik {
+    char* bufor; // Wczytane znaki.
+    size_t poz; // Położenie kolejnego znaku w buforze.
+    size_t ile; // Liczba znaków w buforze.
+    size_t poj; // Pojemność bufora.
+    int plik; // Deskryptor czytanego pliku lub -1, gdy cały jest w buforze.
+    int odwzorowany; // Czy bufor jest odwzorowanym w pamięci plikiem.
 };
-typedef struct kolumny Tkolumny;
+typedef struct czytnik Tczytnik;
 
-/*  Lista zawierająca numery wierszy wraz z listą kolumn w tym wierszu.  */
-struct wiersze {
-    int w;
-    Tkolumny* kolumny; 
-    struct wiersze* nast_w;
+#define ROZMIAR_PISARZA (1 << 16) // Rozmiar bufora wyjścia.
+#define SZEROKOSC_EKRANU (KOLUMNY + 1) // Wiersz okna wraz z końcem wiersza.
+#define BUFORY_POTOKU 4 // Liczba buforów krążących w potoku wyjścia.
+
+/*  Bufor wyjścia przekazywany między wątkami potoku.  */
+struct bufor_potoku {
+    char* bufor; // Znaki.
+    size_t ile; // Liczba znaków do zapisania.
+    size_t poj; // Pojemność bufora.
+};
+typedef struct bufor_potoku Tbufor_potoku;
+
+/*  Potok wyjścia: osobny wątek zapisuje do pliku kolejne zapełnione 
+    bufory, a w tym czasie wątek główny liczy i wypełnia następny. Gdy 
+    wszystkie bufory czekają na zapis, wątek główny czeka, aż któryś się
+    zwolni.  */
+struct potok {
+    pthread_t watek; // Wątek zapisujący bufory.
+    pthread_mutex_t zamek; // Chroni kolejki buforów.
+    pthread_cond_t pelny; // Sygnał o buforze do zapisania albo o końcu.
+    pthread_cond_t wolny; // Sygnał o zwolnionym buforze.
+    Tbufor_potoku pelne[BUFORY_POTOKU]; // Kolejka buforów do zapisania.
+    int pocz; // Początek kolejki buforów do zapisania.
+    int ile_pelnych; // Długość kolejki buforów do zapisania.
+    Tbufor_potoku wolne[BUFORY_POTOKU]; // Bufory gotowe do wypełnienia.
+    int ile_wolnych; // Liczba buforów gotowych do wypełnienia.
+    FILE* plik; // Plik, do którego trafia wyjście.
+    int koniec; // Czy wątek ma się zakończyć po zapisaniu kolejki.
+};
+typedef struct potok Tpotok;
+
+/*  Bufor wyjścia, z którego całe porcje tekstu trafiają do pliku jednym
+    wywołaniem 'fwrite'. Bufor bez pliku nie jest opróżniany, tylko rośnie,
+    i służy do składania tekstu w pamięci.  */
+struct pisarz {
+    char* bufor; // Znaki czekające na wypisanie.
+    size_t ile; // Liczba znaków w buforze.
+    size_t poj; // Pojemność bufora.
+    FILE* plik; // Plik, do którego trafia wyjście, lub NULL.
+    Tpotok* potok; // Potok, przez który bufor trafia do pliku, lub NULL.
+};
+typedef struct pisarz Tpisarz;
+
+#define ROZMIAR_HISTORII (1 << 12) // Liczba miejsc w historii skrótów.
+
+/*  Wpis historii: skrót zbioru żywych komórek w danej generacji.  */
+struct wpis_historii {
+    uint64_t skrot; // Skrót niezależny od przesunięcia.
+    long long pokolenie; // Numer generacji lub -1, jeśli wpis jest pusty.
+    int w; // Wiersz pierwszej żywej komórki.
+    int k; // Kolumna pierwszej żywej komórki.
+    int zywych; // Liczba żywych komórek.
+};
+typedef struct wpis_historii Twpis_historii;
+
+/*  Licznik generacji i wykrywanie cykli: historia ostatnich skrótów 
+    (nowszy wpis wypiera starszy o tym samym miejscu) i wykryty okres.  */
+struct cykl {
+    long long pokolenie; // Numer bieżącej generacji.
+    Twpis_historii historia[ROZMIAR_HISTORII]; // Historia skrótów.
+    Tzywe kopia; // Kopia generacji, od której sprawdzany jest cykl.
+    int okres; // Wykryty okres lub 0, jeśli cyklu nie wykryto.
+    int dw; // Przesunięcie w wierszach po jednym okresie.
+    int dk; // Przesunięcie w kolumnach po jednym okresie.
+    int kandydat; // Sprawdzany okres lub 0, jeśli nic nie jest sprawdzane.
+    int kandydat_dw; // Sprawdzane przesunięcie w wierszach.
+    int kandydat_dk; // Sprawdzane przesunięcie w kolumnach.
+    long long sprawdzenie; // Generacja, w której kopia ma się powtórzyć.
+    long long bez_bitow; // Generacja, do której tryb automatyczny nie 
+                         // wraca do silnika bitowego.
+};
+typedef struct cykl Tcykl;
+
+#define FAZA_NOWE_ZYWE 0 // Wyznaczanie następnej generacji na planszy.
+#define FAZA_USTAW 1 // Zdejmowanie z planszy poprzedniej generacji.
+#define FAZA_UMIESC 2 // Umieszczanie na planszy nowej generacji.
+#define FAZA_PASMA 3 // Liczenie generacji pasmami wierszy.
+#define FAZA_BITY 4 // Silnik bitowy.
+#define FAZA_HASHLIFE 5 // Silnik HashLife.
+#define FAZA_OBSZARY 6 // Silnik obszarów.
+#define FAZA_WCZYTANIE 7 // Wczytywanie wzoru.
+#define FAZA_OKNO 8 // Wypisywanie okna.
+#define FAZA_ZRZUT 9 // Wypisywanie wszystkich żywych komórek.
+#define FAZA_MIGAWKA 10 // Zapisywanie i wczytywanie migawek.
+#define LICZBA_FAZ 11
+
+/*  Pomiary symulacji. Czasy faz są mierzone tylko w programie 
+    skompilowanym z opcją -DPOMIARY, a bez niej pomiar nic nie kosztuje.  */
+struct pomiary {
+    long long ns[LICZBA_FAZ]; // Łączne czasy faz w nanosekundach.
+    long long ns_zapisane[LICZBA_FAZ]; // Czasy faz przy ostatnim zapisie.
+    long long pokolenie_zapisane; // Numer generacji przy ostatnim zapisie.
+    FILE* plik; // Plik, do którego trafiają kolejne pomiary, lub NULL.
+    int json; // Czy pomiary są zapisywane w formacie JSON, a nie CSV.
+};
+typedef struct pomiary Tpomiary;
+
+/*  Strumień zmian: po każdej generacji trafiają do niego komórki, które 
+    się narodziły i które umarły od poprzedniego zapisu.  */
+struct zmiany {
+    FILE* plik; // Plik ze zmianami lub NULL.
+    Tpisarz pisarz; // Bufor tego pliku.
+    Tzywe poprzednia; // Generacja z poprzedniego zapisu.
+};
+typedef struct zmiany Tzmiany;
+
+#define MAKS_ZMIAN_HISTORII 1024 // Najwięcej zmian po jednej klatce historii.
+
+/*  Generacja zapamiętana w historii: cała (klatka) albo jako komórki, 
+    które zmieniły stan od poprzedniej generacji. Komórki są zapisane tak
+    jak w migawce, po nagłówku z liczbą wierszy i komórek.  */
+struct zapis_historii {
+    long long pokolenie; // Numer generacji.
+    int klatka; // Czy zapisana jest cała generacja.
+    size_t dlugosc; // Długość zapisu w bajtach.
+    char* dane; // Zapis.
+};
+typedef struct zapis_historii Tzapis_historii;
+
+/*  Historia kolejnych ostatnich generacji. Każda generacja ma zapis, 
+    a zapisy zmian odnoszą się do najbliższej wcześniejszej klatki. Nowa
+    klatka powstaje, gdy zmiany od poprzedniej zajmują więcej niż ona sama
+    albo jest ich 'MAKS_ZMIAN_HISTORII', więc powrót do dowolnej generacji
+    kosztuje najwyżej tyle, co odczytanie dwóch klatek i tej liczby zmian.
+    Gdy zapisy przekroczą limit pamięci, najstarsza klatka jest zapominana
+    razem ze swoimi zmianami.  */
+struct historia {
+    size_t limit; // Limit pamięci w bajtach lub 0, jeśli historii nie ma.
+    size_t bajty; // Pamięć zajęta przez zapisy.
+    Tzapis_historii* zapisy; // Zapisy od najstarszego.
+    int ile; // Liczba zapisów.
+    int poj; // Pojemność tablicy 'zapisy'.
+    size_t klatka; // Długość ostatniej klatki.
+    size_t od_klatki; // Łączna długość zmian po ostatniej klatce.
+    int zmiany; // Liczba zmian po ostatniej klatce.
+    Tzywe poprzednia; // Ostatnio zapamiętana generacja.
+    Tzywe roznica; // Bufor na zmiany.
+    Tzywe suma; // Bufor na złożone zmiany.
+    Tpisarz pisarz; // Bufor, w którym składane są zapisy.
+};
+typedef struct historia Thistoria;
+
+/*  Liczniki opisujące bieżący stan symulacji.  */
+struct liczniki {
+    long long pokolenie; // Numer generacji.
+    long long zywe; // Liczba żywych komórek.
+    long long wiersze; // Liczba niepustych wierszy lub -1, gdy nieznana.
+    long long wysokosc; // Wysokość prostokąta ograniczającego żywe komórki.
+    long long szerokosc; // Szerokość tego prostokąta.
+    long long kafelki; // Liczba kafelków lub obszarów planszy.
+    long long bajty; // Pamięć zajęta przez silnik i żywe komórki.
+    long long przydzialy; // Liczba przydziałów pamięci na żywe komórki.
+};
+typedef struct liczniki Tliczniki;
+
+#ifdef POMIARY
+#define POCZATEK_POMIARU(t) long long t = zegar_ns()
+#define KONIEC_POMIARU(sym, faza, t) \
+    ((sym) -> pomiary.ns[faza] += zegar_ns() - (t))
+#else
+#define POCZATEK_POMIARU(t)
+#define KONIEC_POMIARU(sym, faza, t)
+#endif
+
+/*  Stan całej symulacji.  */
+struct symulacja {
+    Tplansza plansza; // Plansza z żywymi komórkami.
+    Tokno okno; // Bieżące okno.
+    Tzywe zywe_wiersze; // Żywe komórki w bieżącej generacji.
+    Tbufory bufory; // Bufory na kolejne generacje.
+    Tbity bity; // Plansza silnika bitowego.
+    Thashlife hl; // Drzewo silnika HashLife.
+    Tobszary obszary; // Plansza silnika obszarów.
+    int pamiec_hashlife; // Limit pamięci na węzły drzewa HashLife w MB.
+    int silnik; // Silnik liczący kolejne generacje.
+    int regula; // Reguła gry.
+    int watki; // Liczba wątków silnika listowego (0 to liczenie na planszy).
+    int tryb_bity; // Czy tryb automatyczny liczy teraz silnikiem bitowym.
+    long long przelaczenia; // Liczba zmian silnika w trybie automatycznym.
+    Tpula pula; // Wątki liczące pasma wierszy.
+    int procesy; // Liczba procesów roboczych silnika listowego lub 0.
+    Tprocesy robocze; // Procesy robocze liczące pasy wierszy.
+    Tpotok potok; // Potok standardowego wyjścia.
+    int potokowo; // Czy standardowe wyjście jest zapisywane w osobnym wątku.
+    Tczytnik czytnik; // Czytnik standardowego wejścia.
+    Tpisarz pisarz; // Bufor standardowego wyjścia.
+    Tcykl cykl; // Licznik generacji i wykrywanie cykli.
+    Tpomiary pomiary; // Czasy faz i plik z pomiarami.
+    const char* plik_pomiarow; // Nazwa pliku z pomiarami lub NULL.
+    Tzmiany zmiany; // Strumień zmian.
+    const char* plik_zmian; // Nazwa pliku ze zmianami lub NULL.
+    Thistoria historia; // Historia ostatnich generacji.
+    int pamiec_historii; // Limit pamięci historii w MB lub 0.
+    const char* wzor; // Plik z początkową generacją lub NULL.
+    const char* wydajnosc; // Początek nazw wzorów testu wydajności lub NULL.
+    long long wsadowo; // Liczba generacji w trybie wsadowym lub -1.
+    long long co; // Odstęp między wynikami w trybie wsadowym lub 0.
+    int wyjscie; // Co wypisuje tryb wsadowy.
+    long long zupy; // Liczba zup w przeglądzie zup lub 0.
+    long long ziarno; // Numer pierwszej zupy przeglądu.
+    int bok_zupy; // Bok zup przeglądu.
+    int gestosc_zupy; // Odsetek żywych komórek zup przeglądu.
+    int wysokosc; // Liczba wierszy planszy o stałych wymiarach lub 0.
+    int szerokosc; // Liczba kolumn planszy o stałych wymiarach lub 0.
+    int torus; // Czy brzegi planszy o stałych wymiarach są sklejone.
+};
+typedef struct symulacja Tsymulacja;
+
+#define ZNACZEK_MIGAWKI "ZYCIEMIG" // Pierwsze 8 bajtów pliku migawki.
+#define WERSJA_MIGAWKI 1 // Wersja formatu migawki.
+#define NAGLOWEK_MIGAWKI 48 // Rozmiar nagłówka migawki w bajtach.
+#define DLUGOSC_NAZWY 4096 // Pojemność nazwy pliku podanej w poleceniu.
+
+#define WYJSCIE_ZRZUT 0 // Tryb wsadowy wypisuje wszystkie żywe komórki.
+#define WYJSCIE_OKNO 1 // Tryb wsadowy wypisuje okno.
+#define WYJSCIE_STATYSTYKI 2 // Tryb wsadowy wypisuje statystyki.
+
+#define WZOR_RLE 0 // Wzór zapisany w formacie RLE.
+#define WZOR_ZUPA 1 // Losowa zupa komórek w kwadracie.
+#define WZOR_BLOKI 2 // Kwadrat wypełniony blokami 2 x 2.
+#define WZOR_DZIALA 3 // Rząd dział Gospera strzelających równolegle.
+
+#define ODSTEP_DZIAL 40 // Przesunięcie kolejnych dział w rzędzie.
+#define ODCINKI_POMIARU 10 // Liczba odcinków, na które dzielone są generacje.
+
+/*  Wzór z zestawu testu wydajności.  */
+struct wzor_testowy {
+    const char* nazwa; // Nazwa wzoru w wynikach.
+    int rodzaj; // Sposób tworzenia wzoru.
+    const char* rle; // Wzór lub jego cegiełka w formacie RLE.
+    int bok; // Bok kwadratu albo liczba dział.
+    int gestosc; // Odsetek żywych komórek zupy.
+    int generacje; // Liczba liczonych generacji.
 };
-typedef struct wiersze Twiersze;
+typedef struct wzor_testowy Twzor_testowy;
 
-/*  Funkcja przekazująca optymalną wartość, o jaką należy poszerzyć planszę.  */
-int wiecej(int n) {
-    return n / 2 + 40;
+#define BOK_ZUPY 32 // Domyślny bok zup w przeglądzie zup.
+#define GESTOSC_ZUPY 50 // Domyślny odsetek żywych komórek zupy.
+#define GENERACJE_ZUPY 10000 // Domyślna liczba generacji każdej zupy.
+
+/*  Wynik jednej zupy z przeglądu zup.  */
+struct wynik_zupy {
+    long long zywe; // Liczba żywych komórek na końcu.
+    long long wysokosc; // Wysokość prostokąta z żywymi komórkami.
+    long long szerokosc; // Szerokość prostokąta z żywymi komórkami.
+    int okres; // Wykryty okres lub 0.
+    int dw; // Przesunięcie w wierszach po jednym okresie.
+    int dk; // Przesunięcie w kolumnach po jednym okresie.
+};
+typedef struct wynik_zupy Twynik_zupy;
+
+/*  Zupy czekające na policzenie przez jeden wątek przeglądu: numery od 
+    'od' do 'do_' (bez niego). Wątek bierze zupy z początku swojego 
+    zakresu, a gdy zakres się skończy, zabiera drugą połowę zakresu 
+    innego wątku.  */
+struct kolejka_zup {
+    pthread_mutex_t zamek; // Chroni zakres.
+    long long od; // Pierwsza zupa zakresu.
+    long long do_; // Zupa tuż za zakresem.
+};
+typedef struct kolejka_zup Tkolejka_zup;
+
+/*  Przegląd wielu niezależnych zup liczonych przez kilka wątków, z których
+    każdy ma własną symulację.  */
+struct przeglad {
+    Tsymulacja* opcje; // Opcje symulacji wszystkich wątków.
+    int ile_watkow; // Liczba wątków (łącznie z głównym).
+    Tkolejka_zup* kolejki; // Zakresy zup kolejnych wątków.
+    Twynik_zupy* wyniki; // Wyniki wszystkich zup.
+    long long kradziezy; // Liczba zakresów zabranych innym wątkom.
+    pthread_mutex_t zamek_kradziezy; // Chroni licznik kradzieży.
+};
+typedef struct przeglad Tprzeglad;
+
+/*  Dane przekazywane wątkowi przeglądu zup.  */
+struct liczacy_zupy {
+    Tprzeglad* przeglad; // Przegląd, do którego należy wątek.
+    int nr; // Numer wątku i jego kolejki.
+};
+typedef struct liczacy_zupy Tliczacy_zupy;
+
+/*  Inicjalizuje czytnik 'c' czytający z pliku o deskryptorze 'plik'.  */
+WEWNETRZNA void inicjalizuj_czytnik(Tczytnik* c, int plik) {
+    c -> poj = ROZMIAR_CZYTNIKA;
+    c -> bufor = (char*) malloc(c -> poj);
+    assert(c -> bufor != NULL);
+    c -> poz = 0;
+    c -> ile = 0;
+    c -> plik = plik;
+    c -> odwzorowany = 0;
+}
+
+/*  Inicjalizuje czytnik 'c' czytający zawartość pliku o nazwie 'nazwa' 
+    odwzorowaną w pamięci. Przekazuje 0, jeśli pliku nie da się otworzyć, 
+    a w przeciwnym przypadku 1.  */
+WEWNETRZNA int otworz_czytnik(Tczytnik* c, const char* nazwa) {
+    int plik = open(nazwa, O_RDONLY);
+    struct stat dane;
+    if (plik < 0 || fstat(plik, &dane) != 0) {
+        if (plik >= 0) {
+            close(plik);
+        }
+        return 0;
+    }
+    c -> poz = 0;
+    c -> ile = (size_t) dane.st_size;
+    c -> poj = c -> ile;
+    c -> plik = -1;
+    c -> odwzorowany = c -> ile > 0;
+    c -> bufor = NULL;
+    if (c -> odwzorowany) {
+        void* p = mmap(NULL, c -> ile, PROT_READ, MAP_PRIVATE, plik, 0);
+        if (p == MAP_FAILED) {
+            close(plik);
+            return 0;
+        }
+        c -> bufor = (char*) p;
+        posix_madvise(p, c -> ile, POSIX_MADV_SEQUENTIAL);
+    }
+    close(plik);
+    return 1;
+}
+
+/*  Zwalnia pamięć zarezerwowaną przez czytnik 'c'.  */
+WEWNETRZNA void zwolnij_czytnik(Tczytnik* c) {
+    if (c -> odwzorowany) {
+        munmap(c -> bufor, c -> ile);
+    }
+    else if (c -> plik >= 0) {
+        free(c -> bufor);
+    }
+}
+
+/*  Inicjalizuje czytnik 'c' czytający 'dlugosc' znaków tekstu 'tekst'.
+    Tekst należy do wywołującego, a czytnik nigdy go nie zmienia.  */
+WEWNETRZNA void czytnik_z_tekstu(Tczytnik* c, const char* tekst, 
+    size_t dlugosc) {
+
+    c -> bufor = (char*) tekst;
+    c -> poz = 0;
+    c -> ile = dlugosc;
+    c -> poj = dlugosc;
+    c -> plik = -1;
+    c -> odwzorowany = 0;
 }
 
-/*  Zwalnia pamięć zarezerwowaną przez dwuwymiarową tablicę 'tab' 
-    o wymiarach 'wymiary'.  */
-void zwolnij_2D(char** tab, Twymiary wymiary) {
-    int m = wymiary.m;
-    for (int i = 0; i < m; i++) {
-        free(tab[i]);
+/*  Wczytuje do bufora czytnika 'c' kolejną porcję pliku. Przekazuje 0, 
+    jeśli plik się skończył, a w przeciwnym przypadku 1.  */
+WEWNETRZNA int uzupelnij(Tczytnik* c) {
+    if (c -> plik < 0) {
+        return 0;
     }
-    free(tab);
+    ssize_t r;
+    do {
+        r = read(c -> plik, c -> bufor, c -> poj);
+    } while (r < 0 && errno == EINTR);
+    if (r <= 0) {
+        return 0;
+    }
+    c -> poz = 0;
+    c -> ile = (size_t) r;
+    return 1;
 }
 
-/*  Zwalnia pamięć zarezerwowaną przez listę kolumn zaczynajacą się w 'l'.  */
-void zwolnij_kolumny(Tkolumny** l) {
-    Tkolumny* akt = *l;
-    Tkolumny* temp;
-    while (akt != NULL) { 
-        temp = akt -> nast_k;
-        free(akt);
-        akt = temp;
+/*  Przekazuje kolejny znak z czytnika 'c' bez pobierania go albo EOF, 
+    jeśli wejście się skończyło.  */
+WEWNETRZNA int podejrzyj(Tczytnik* c) {
+    if (c -> poz == c -> ile && !uzupelnij(c)) {
+        return EOF;
     }
-    *l = NULL;
+    return (unsigned char) c -> bufor[c -> poz];
 }
 
-/*  Zwalnia pamięć zarezerwowaną przez listę wierszy zaczynajacą się w 'l'.  */
-void zwolnij_wiersze(Twiersze** l) {
-    Twiersze* akt = *l;
-    Twiersze* temp;
-    while (akt != NULL) { 
-        zwolnij_kolumny(&(akt -> kolumny));
-        temp = akt -> nast_w;
-        free(akt);
-        akt = temp;
+/*  Pobiera kolejny znak z czytnika 'c' albo przekazuje EOF, jeśli wejście
+    się skończyło.  */
+WEWNETRZNA int pobierz(Tczytnik* c) {
+    int znak = podejrzyj(c);
+    if (znak != EOF) {
+        c -> poz++;
     }
-    *l = NULL;
+    return znak;
 }
 
-/*  Czyści strumień wejściowy.  */
-void wyczysc_strumien(void) {
-    int znak;
-    while (((znak = getchar()) != ENTER) && (znak != EOF)); 
-}
-
-/*  Tworzy atrapę na liście kolumn 'l'.  */
-void stworz_atrape_k(Tkolumny** l) {
-    *l = (Tkolumny*) malloc(sizeof(Tkolumny));
-    assert(*l != NULL);
-    (*l) -> nast_k = NULL;
-}
-
-/*  Tworzy atrapę na liście wierszy 'l'.  */
-void stworz_atrape_w(Twiersze** l) {
-    *l = (Twiersze*) malloc(sizeof(Twiersze));
-    assert(*l != NULL);
-    (*l) -> nast_w = NULL;
-    (*l) -> kolumny = NULL;
-}
-
-/*  Inicjalizuje tablicę 'tab' tak, aby miała 'm' wierszy i 'n' kolumn.  
-    Wypełnia ją zerami (martwymi komórkami). */
-void inicjalizuj(char*** tab, int m, int n) {
-    char** pom = (char**) malloc((size_t) m * sizeof(char*));
-    assert(pom != NULL);
-    for (int i = 0; i < m; i++) {
-        pom[i] = (char*) calloc((size_t) n, sizeof(char));
-        assert(pom[i] != NULL);
-    }
-    *tab = pom;
-}
-
-/*  Wstawia kolumnę 'x' za element 'l1' na liście kolumn w danym wierszu.  */
-void wstaw_za_kolumne(Tkolumny* l1, int x) {
-    Tkolumny* pom;
-    pom = (Tkolumny*) malloc(sizeof(Tkolumny));
-    assert(pom != NULL);
-    pom -> k = x;
-    pom -> nast_k = l1 -> nast_k;
-    l1 -> nast_k = pom;
-}
-
-/*  Wstawia wiersz 'x' z kolumnami reprezentowanymi na liście 'l2' za element 
-    'l1' na liście wierszy.  */
-void wstaw_za_wiersz(Twiersze* l1, int x, Tkolumny* l2) {
-    Twiersze* pom;
-    pom = (Twiersze*) malloc(sizeof(Twiersze));
-    assert(pom != NULL);
-    pom -> w = x;
-    pom -> kolumny = l2;
-    pom -> nast_w = l1 -> nast_w;
-    l1 -> nast_w = pom;
-}
-
-/*  Dołącza listę kolumn 'l2' za element 'l1'.  */
-void dolacz_na_koniec_k(Tkolumny* l1, Tkolumny* l2) {
-    if (l1 != NULL && l2 != NULL) {
-        l1 -> nast_k = l2;
-    }
-}
-
-/*  Dołącza listę wierszy 'l2' za element 'l1'.  */
-void dolacz_na_koniec_w(Twiersze* l1, Twiersze* l2) {
-    if (l1 != NULL && l2 != NULL) {
-        l1 -> nast_w = l2;
-    }
-}
-
-/*  Scala dwie listy z kolumnami 'l1' i 'l2' posortowane rosnąco i przekazuje 
-    wskaźnik do wyniku. Zwalnia również pamięć zarezerwowaną przez listy 
-    'l1' i 'l2'.  */
-Tkolumny* scal_posort_k(Tkolumny* l1, Tkolumny* l2) {
-    Tkolumny* do_usuniecia;
-    Tkolumny* pom; // Lista wynikowa.
-    stworz_atrape_k(&pom);
-    Tkolumny* akt_pom = pom;
-    // Omijamy atrapy na listach 'l1' i 'l2'.
-    Tkolumny* akt1 = l1 -> nast_k;
-    Tkolumny* akt2 = l2 -> nast_k;
-    // I je zwalniamy.
-    free(l1);
-    free(l2);
-    while (akt1 != NULL && akt2 != NULL) {
-        if (akt1 -> k < akt2 -> k) {
-            wstaw_za_kolumne(akt_pom, akt1 -> k);
-            do_usuniecia = akt1;
-            akt1 = akt1 -> nast_k;
-            free(do_usuniecia);
-        }
-        else if (akt1 -> k > akt2 -> k) {
-            wstaw_za_kolumne(akt_pom, akt2 -> k);
-            do_usuniecia = akt2;
-            akt2 = akt2 -> nast_k;
-            free(do_usuniecia);
-        }
-        else { // Jeśli takie same.
-            wstaw_za_kolumne(akt_pom, akt1 -> k);
-            do_usuniecia = akt1;
-            akt1 = akt1 -> nast_k;
-            free(do_usuniecia);
-            do_usuniecia = akt2;
-            akt2 = akt2 -> nast_k;
-            free(do_usuniecia);
-        }
-        akt_pom = akt_pom -> nast_k;
-    }
-    // Dopisywanie reszty listy, jeśli któraś się skończyła.
-    if (akt1 == NULL) {
-        dolacz_na_koniec_k(akt_pom, akt2);
-    }
-    else { // akt2 == NULL
-        dolacz_na_koniec_k(akt_pom, akt1);
-    }
-    return pom;
-}
-
-/*  Scala dwie listy z wierszami 'l1' i 'l2' posortowane rosnąco i przekazuje 
-    wskaźnik do wyniku. Zwalnia również pamięć zarezerwowaną przez listy 
-    'l1' i 'l2'.  */
-Twiersze* scal_posort_w(Twiersze* l1, Twiersze* l2) {
-    Tkolumny* nowe;
-    Twiersze* do_usuniecia;
-    Twiersze* pom; // Lista wynikowa.
-    stworz_atrape_w(&pom);
-    Twiersze* akt_pom = pom;
-    // Omijamy atrapy na listach 'l1' i 'l2'.
-    Twiersze* akt1 = l1 -> nast_w;
-    Twiersze* akt2 = l2 -> nast_w;
-    // I je zwalniamy.
-    free(l1);
-    free(l2);
-    while (akt1 != NULL && akt2 != NULL) {
-        if (akt1 -> w < akt2 -> w) {
-            wstaw_za_wiersz(akt_pom, akt1 -> w, akt1 -> kolumny);
-            do_usuniecia = akt1;
-            akt1 = akt1 -> nast_w;
-            free(do_usuniecia);
-        }
-        else if (akt1 -> w > akt2 -> w) {
-            wstaw_za_wiersz(akt_pom, akt2 -> w, akt2 -> kolumny);
-            do_usuniecia = akt2;
-            akt2 = akt2 -> nast_w;
-            free(do_usuniecia);
-        }
-        else { // Jeśli takie same.
-            nowe = scal_posort_k(akt1 -> kolumny, akt2 -> kolumny);
-            wstaw_za_wiersz(akt_pom, akt1 -> w, nowe);
-            do_usuniecia = akt1;
-            akt1 = akt1 -> nast_w;
-            free(do_usuniecia);
-            do_usuniecia = akt2;
-            akt2 = akt2 -> nast_w;
-            free(do_usuniecia);
-        }
-        akt_pom = akt_pom -> nast_w;
-    }
-    // Dopisywanie reszty listy, jeśli któraś się skonczyła.
-    if (akt1 == NULL) {
-        dolacz_na_koniec_w(akt_pom, akt2);
-    }
-    else { // akt2 == NULL
-        dolacz_na_koniec_w(akt_pom, akt1);
-    }
-    return pom;
-}
-
-/*  Ustawia pola planszy reprezentowane na liście 'wiersze' na znak 'jak'.  */
-void ustaw(char*** tab, Twymiary wymiary, Twiersze* wiersze, char jak) {
-    Twiersze* akt_w;
-    Tkolumny* akt_k;
-    // Omijamy atrapę na liście żywych wierszy.
-    akt_w = wiersze -> nast_w;
-    while (akt_w != NULL) {
-        // Omijamy atrapę na liście żywych kolumn.
-        akt_k = akt_w -> kolumny -> nast_k;
-        while (akt_k != NULL) {
-            (*tab)[(akt_w -> w) - (wymiary.min_w)]
-                  [(akt_k -> k) - (wymiary.min_k)] = jak;
-            akt_k = akt_k -> nast_k;
-        }
-        akt_w = akt_w -> nast_w;
-    }
-}
-
-/*  Rozszerza tablicę 'tab' tak, aby miała o 'm' więcej wierszy i o 'n' więcej 
-    kolumn oraz zeruje wszystkie jej pola.  */
-void rozszerz_i_wyzeruj(char*** tab, int m, int n, Twymiary wymiary) {
-    zwolnij_2D(*tab, wymiary);
-    char** pom;
-    inicjalizuj(&pom, wymiary.m + m, wymiary.n + n);
-    *tab = pom;
-}
-
-/*  Jeśli trzeba, rozszerza tablicę 'tab' w dowolnym kierunku. Aktualizuje
-    również parametry planszy w zmiennej 'wymiary'.  Jeśli tablica została
-    wyzerowana, przekazuje 1, w przecwinym razie przekazuje 0.  */
-int rozszerz_tab(
-    char*** tab, int dol, int gora, int prawo, int lewo, Twymiary* wymiary) {
-
-    if (dol != 0 || gora != 0 || prawo != 0 || lewo != 0) {
-        rozszerz_i_wyzeruj(tab, dol + gora, prawo + lewo, *wymiary);
-        wymiary -> max_w += dol;
-        wymiary -> min_w -= gora;
-        wymiary -> max_k += prawo;
-        wymiary -> min_k -= lewo;
-        wymiary -> m += dol + gora;
-        wymiary -> n += prawo + lewo;
-    }
-    return dol != 0 || gora != 0 || prawo != 0 || lewo != 0;
-}
-
-/*  Jeśli trzeba, rozszerza planszę tak, aby można było wypisać okno.  */
-void rozszerz_okno(
-    char*** tab, int w, int k, Twymiary* wymiary, Twiersze* zywe_wiersze) {
-
-    // O ile trzeba rozszerzyć.
-    int dol = 0;
-    int gora = 0;
-    int prawo = 0;
-    int lewo = 0;
-    if (w + WIERSZE - 1 > wymiary -> max_w) {
-        // Jeśli okno wyszłoby poza dolny zakres.
-        dol = WIERSZE - ((wymiary -> max_w) + 1 - w);
-    }
-    if (w < wymiary -> min_w) {
-        // Jeśli okno wyszłoby poza górny zakres.
-        gora = (wymiary -> min_w) - w;
-    }
-    if (k + KOLUMNY - 1 > wymiary -> max_k) {
-        // Jeśli okno wyszłoby poza prawy zakres.
-        prawo = KOLUMNY - ((wymiary -> max_k) + 1 - k);
-    }
-    if (k < wymiary -> min_k) {
-        // Jeśli okno wyszłoby poza lewy zakres.
-        lewo = (wymiary -> min_k) - k;
-    }
-    if (rozszerz_tab(tab, dol, gora, prawo, lewo, wymiary)) {
-        ustaw(tab, *wymiary, zywe_wiersze, ZYWA);
-    }
-}
-
-/*  Rozszerza planszę tak, by była pewność, że podwójne otoczenie 
-    (czyli sąsiedzi wszystkich sąsiadów) komórek reprezentowanych na liście 
-    'wiersze' jest zaalokowane. 
-    Jeśli trzeba, alokuje wiecej wierszy lub kolumn.  */
-void rozszerz_otoczenie(char*** tab, Twymiary* wymiary, Twiersze* wiersze) {
-    int dol, gora, prawo, lewo;
-    int w, k;
-    Twiersze* akt_w;
-    Tkolumny* akt_k;
-    // Omijamy atrapę na liście żywych wierszy.
-    akt_w = wiersze -> nast_w;
-    while (akt_w != NULL) {
-        // Omijamy atrapę na liście żywych kolumn.
-        akt_k = akt_w -> kolumny -> nast_k;
-        while (akt_k != NULL) {
-            dol = 0;
-            gora = 0;
-            prawo = 0;
-            lewo = 0;
-            w = akt_w -> w;
-            k = akt_k -> k;
-            if (w + 2 > wymiary -> max_w) {
-                dol = wiecej(wymiary -> m);
-            }
-            if (w - 2 < wymiary -> min_w) {
-                gora = wiecej(wymiary -> m);
-            }
-            if (k + 2 > wymiary -> max_k) {
-                prawo = wiecej(wymiary -> n);
-            }
-            if (k - 2 < wymiary -> min_k) {
-                lewo = wiecej(wymiary -> n);
+/*  Pomija odstępy w obrębie wiersza i wczytuje z czytnika 'c' liczbę 
+    całkowitą do '*x'. Przekazuje 0, jeśli nie było tam liczby, 
+    a w przeciwnym przypadku 1.  */
+WEWNETRZNA int wczytaj_liczbe(Tczytnik* c, int* x) {
+    int znak = podejrzyj(c);
+    while (znak == SPACJA || znak == '\t' || znak == '\r') {
+        c -> poz++;
+        znak = podejrzyj(c);
+    }
+    int minus = znak == '-';
+    if (minus) {
+        c -> poz++;
+        znak = podejrzyj(c);
+    }
+    if (znak < '0' || znak > '9') {
+        return 0;
+    }
+    long long wynik = 0;
+    do {
+        // Wewnątrz bufora cyfry są czytane bez sprawdzania końca pliku.
+        while (c -> poz < c -> ile && c -> bufor[c -> poz] >= '0' 
+               && c -> bufor[c -> poz] <= '9') {
+            if (wynik <= INT_MAX) {
+                wynik = 10 * wynik + (c -> bufor[c -> poz] - '0');
             }
-            rozszerz_tab(tab, dol, gora, prawo, lewo, wymiary);
-            akt_k = akt_k -> nast_k;
+            c -> poz++;
+        }
+        znak = podejrzyj(c);
+    } while (znak >= '0' && znak <= '9');
+    wynik = wynik > INT_MAX ? INT_MAX : wynik;
+    *x = (int) (minus ? -wynik : wynik);
+    return 1;
+}
+
+/*  Czyści strumień wejściowy czytnika 'c' do końca wiersza.  */
+WEWNETRZNA void wyczysc_strumien(Tczytnik* c) {
+    int znak;
+    while (((znak = pobierz(c)) != ENTER) && (znak != EOF)); 
+}
+
+/*  Inicjalizuje pusty zbiór żywych komórek 'z'.  */
+WEWNETRZNA void inicjalizuj_zywe(Tzywe* z) {
+    z -> ile_w = 0;
+    z -> poj_w = 0;
+    z -> poj_k = 0;
+    z -> w = NULL;
+    z -> k = NULL;
+    z -> przydzialy = 0;
+    z -> pocz = (int*) malloc(sizeof(int));
+    assert(z -> pocz != NULL);
+    z -> pocz[0] = 0;
+}
+
+/*  Zwalnia pamięć zarezerwowaną przez zbiór żywych komórek 'z'.  */
+WEWNETRZNA void zwolnij_zywe(Tzywe* z) {
+    free(z -> w);
+    free(z -> pocz);
+    free(z -> k);
+}
+
+/*  Przekazuje liczbę żywych komórek w zbiorze 'z'.  */
+WEWNETRZNA int ile_zywych(Tzywe* z) {
+    return z -> pocz[z -> ile_w];
+}
+
+/*  Dba o to, aby w zbiorze 'z' zmieściło się 'wiersze' wierszy i 'kolumny'
+    kolumn. W razie potrzeby co najmniej podwaja pojemność tablic.  */
+WEWNETRZNA void zarezerwuj(Tzywe* z, int wiersze, int kolumny) {
+    if (wiersze > z -> poj_w) {
+        int poj = 2 * (z -> poj_w) > wiersze ? 2 * (z -> poj_w) : wiersze;
+        z -> w = (int*) realloc(z -> w, (size_t) poj * sizeof(int));
+        z -> pocz = (int*) realloc(z -> pocz, (size_t) (poj + 1) * sizeof(int));
+        assert(z -> w != NULL && z -> pocz != NULL);
+        z -> poj_w = poj;
+        z -> przydzialy += 2;
+    }
+    if (kolumny > z -> poj_k) {
+        int poj = 2 * (z -> poj_k) > kolumny ? 2 * (z -> poj_k) : kolumny;
+        z -> k = (int*) realloc(z -> k, (size_t) poj * sizeof(int));
+        assert(z -> k != NULL);
+        z -> poj_k = poj;
+        z -> przydzialy++;
+    }
+}
+
+/*  Opróżnia zbiór 'z', nie zwalniając jego pamięci.  */
+WEWNETRZNA void wyczysc_zywe(Tzywe* z) {
+    z -> ile_w = 0;
+    z -> pocz[0] = 0;
+}
+
+/*  Kończy wiersz dopisywany na końcu zbioru 'z', którego kolumny zajmują
+    tablicę 'k' do indeksu 'koniec' (bez niego). Pusty wiersz jest 
+    pomijany.  */
+WEWNETRZNA void zakoncz_wiersz(Tzywe* z, int koniec) {
+    if (koniec > z -> pocz[z -> ile_w]) {
+        z -> ile_w++;
+        z -> pocz[z -> ile_w] = koniec;
+    }
+}
+
+/*  Miesza bity słowa 'x' (funkcja kończąca generatora SplitMix64).  */
+WEWNETRZNA uint64_t wymieszaj(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/*  Przekazuje skrót zbioru 'z' niezależny od jego przesunięcia i zapisuje
+    w '*w' i '*k' położenie pierwszej komórki zbioru, względem której 
+    liczone są położenia pozostałych.  */
+WEWNETRZNA uint64_t skrot_zywych(Tzywe* z, int* w, int* k) {
+    *w = z -> ile_w > 0 ? z -> w[0] : 0;
+    *k = z -> ile_w > 0 ? z -> k[0] : 0;
+    uint64_t skrot = 0;
+    for (int i = 0; i < z -> ile_w; i++) {
+        uint64_t wiersz = (uint64_t) (uint32_t) (z -> w[i] - *w) << 32;
+        for (int j = z -> pocz[i]; j < z -> pocz[i + 1]; j++) {
+            skrot += wymieszaj(wiersz | (uint32_t) (z -> k[j] - *k));
         }
-        akt_w = akt_w -> nast_w;
     }
-    ustaw(tab, *wymiary, wiersze, ZYWA);
+    return skrot;
 }
 
-/*  Wypisuje okno zadane przez 'okno' o 'WIERSZE' wierszach 
-    i 'KOLUMNY' kolumnach.  */
-void wypisz_okno(char** tab, Tokno okno, Twymiary wymiary) {
-    int w = okno.w, k = okno.k;
-    int min_w = wymiary.min_w, min_k = wymiary.min_k;
-    for (int i = w - min_w; i < w - min_w + WIERSZE; i++) {
-        for (int j = k - min_k; j < k - min_k + KOLUMNY; j++) {
-            switch (tab[i][j]) {
-                case ZYWA:
-                    putchar(ZYWA);
-                    break;
-                case MARTWA:
-                    putchar(KROPKA);
-                    break;
-                default: assert(0); // Błąd
-            }
-        }
-        putchar(ENTER);
-    }
-    for (int i = 0; i < KOLUMNY; i++) {
-        putchar(ROWNASIE);
-    }
-    putchar(ENTER);
-}
-
-/*  Wczytuje żywe wiersze i żywe kolumny w początkowej generacji do listy 
-    'zywe_wiersze'.  */
-void wczytaj_generacje(Twiersze* zywe_wiersze) {
-    Tkolumny* kol_nowe;
-    Tkolumny* akt_k;
-    int w, k;
-    char znak;
-    int koniec = 0; // Flaga oznaczająca koniec wczytywania.
-    while (!koniec) {
-        getchar(); // Pomiń pierwszy slash.
-        znak = (char) getchar(); // Podejrzyj znak po slashu.
-        ungetc(znak, stdin);
-        if (znak == ENTER) {
-            koniec = 1;
+/*  Przekazuje 1, jeśli zbiór 'a' to zbiór 'b' przesunięty o 'dw' wierszy
+    i 'dk' kolumn, a w przeciwnym przypadku 0.  */
+WEWNETRZNA int rowne_z_przesunieciem(Tzywe* a, Tzywe* b, int dw, int dk) {
+    if (a -> ile_w != b -> ile_w || ile_zywych(a) != ile_zywych(b)) {
+        return 0;
+    }
+    for (int i = 0; i < a -> ile_w; i++) {
+        if (a -> w[i] != b -> w[i] + dw 
+            || a -> pocz[i + 1] != b -> pocz[i + 1]) {
+            return 0;
         }
-        else {
-            scanf("%d", &w);
-            // Dodajemy wczytany wiersz do listy żywych wierszy.
-            wstaw_za_wiersz(zywe_wiersze, w, NULL);
-            // Tworzymy atrapę na liście kolumn w dodanym wierszu.
-            stworz_atrape_k(&(zywe_wiersze -> nast_w -> kolumny));
-            kol_nowe = zywe_wiersze -> nast_w -> kolumny;
-            akt_k = kol_nowe;
-            // Wczytywanie żywych kolumn w wierszu 'w'.
-            do {
-                scanf("%d%c", &k, &znak);
-                wstaw_za_kolumne(akt_k, k);
-                akt_k = akt_k -> nast_k;
-            } while (znak == SPACJA);
-            // Jeśli dodaliśmy jakieś kolumny, idziemy dalej.
-            if (akt_k != kol_nowe) {
-                zywe_wiersze = zywe_wiersze -> nast_w;
-            }
-            // Jeśli nie, usuwamy dodany wiersz.
-            else {
-                zwolnij_wiersze(&(zywe_wiersze -> nast_w));
-            }
+    }
+    for (int j = 0; j < ile_zywych(a); j++) {
+        if (a -> k[j] != b -> k[j] + dk) {
+            return 0;
         }
     }
+    return 1;
 }
 
-/*  Wypisuje stan aktualnej generacji.  */
-void zrzut(Twiersze* zywe_wiersze) {
-    Twiersze* akt_w;
-    Tkolumny* akt_k;
-    // Omijamy atrapę na liście żywych wierszy.
-    akt_w = zywe_wiersze -> nast_w;
-    while (akt_w != NULL) {
-        printf("%c%d", SLASH, akt_w -> w);
-        // Omijamy atrapę na liście żywych kolumn.
-        akt_k = akt_w -> kolumny -> nast_k;
-        while (akt_k != NULL) {
-            printf(" %d", akt_k -> k);
-            akt_k = akt_k -> nast_k;
-        }
-        putchar(ENTER);
-        akt_w = akt_w -> nast_w;
-    }
-    putchar(SLASH);
-    putchar(ENTER);
-}
-
-/*  Sprawdza, czy komórka na polu 'stara[w][k]' powinna być żywa w następnej 
-    generacji. Jeśli tak, funkcja zwraca wartość '1', jeśli nie, zwraca '0'.
-    Co więcej, jeśli komórka powinna być żywa, zaznacza ten fakt na planszy, 
-    aby uniknąć niepotrzebnego ponownego sprawdzania. */
-int sprawdz(char** stara, int w, int k) {
-    char komorka; // Rozważana komórka.
-    int ile_zywych = 0;
-    // Zliczanie żywych sąsiadów.
-    for (int i = -1; i < 2; i++) {
-        for (int j = -1; j < 2; j++) {
-            komorka = stara[w + i][k + j];
-            if (komorka == ZYWA || komorka == ODWIEDZONA_ZYWA) {
-                ile_zywych++;
-            }
-        }
+/*  Przesuwa wszystkie komórki zbioru 'z' o 'dw' wierszy i 'dk' kolumn.  */
+WEWNETRZNA void przesun_zywe(Tzywe* z, long long dw, long long dk) {
+    for (int i = 0; i < z -> ile_w; i++) {
+        z -> w[i] = (int) (z -> w[i] + dw);
     }
-    switch (stara[w][k]) {
-        case ZYWA:
-            ile_zywych--; // Wtedy policzyliśmy o jedną żywą za dużo.
-            stara[w][k] = ODWIEDZONA_ZYWA;
-            if (ile_zywych == 2 || ile_zywych == 3) {
-                return 1;
-            }
-            break;
-        case MARTWA:
-            if (ile_zywych == 3) {
-                stara[w][k] = ODWIEDZONA_MARTWA;
-                return 1;
-            }
-            break;
-        default: assert(0); // Błąd.
+    for (int j = 0; j < ile_zywych(z); j++) {
+        z -> k[j] = (int) (z -> k[j] + dk);
     }
-    return 0;
 }
 
-/*  Sprawdza, czy komórki znajdujące się o 'offset' powyżej lub ponizej żywych 
-    komórek w wierszu 'akt_w' powinny być żywe w następnej generacji. 
-    Jeśli komórka powinna być żywa, jest dopisywana za element 'z' na listę.  */
-void sprawdz_otoczenie(
-    char** stara, 
-    int offset, 
-    Twiersze* akt_w,
-    Twiersze* z,
-    Twymiary wymiary) {
+/*  Kopiuje zbiór 'z' do zbioru 'kopia'.  */
+WEWNETRZNA void kopiuj_zywe(Tzywe* z, Tzywe* kopia) {
+    kopia -> ile_w = z -> ile_w;
+    kopia -> pocz[0] = 0;
+    if (z -> ile_w == 0) {
+        // Pusty zbiór może nie mieć jeszcze tablic.
+        return;
+    }
+    zarezerwuj(kopia, z -> ile_w, ile_zywych(z));
+    memcpy(kopia -> w, z -> w, (size_t) z -> ile_w * sizeof(int));
+    memcpy(kopia -> pocz, z -> pocz, (size_t) (z -> ile_w + 1) * sizeof(int));
+    memcpy(kopia -> k, z -> k, (size_t) ile_zywych(z) * sizeof(int));
+}
 
-    char komorka; // Rozważana komórka.
-    // Dodajemy rozważany wiersz do listy żywych komórek w następnej generacji.
-    wstaw_za_wiersz(z, (akt_w -> w) + offset, NULL);
-    // Tworzymy atrapę listy kolumn w tym wierszu.
-    stworz_atrape_k(&(z -> nast_w -> kolumny));
-    // Inicjalizacja wskaźników pomocniczych.
-    Tkolumny* kol_nowe_z = z -> nast_w -> kolumny;
-    Tkolumny* akt_z = kol_nowe_z;
-    int wiersz, kolumna;
-    wiersz = (akt_w -> w) - wymiary.min_w + offset;
-    // Omijamy atrapę na liście żywych kolumn.
-    Tkolumny* akt_k = akt_w -> kolumny -> nast_k;
-    while (akt_k != NULL) {
-        for (int i = -1; i < 2; i++) {
-            kolumna = (akt_k -> k) - wymiary.min_k + i;
-            komorka = stara[wiersz][kolumna];
-            if (komorka == ZYWA || komorka == MARTWA) {
-                if (sprawdz(stara, wiersz, kolumna)) {
-                    wstaw_za_kolumne(akt_z, (akt_k -> k) + i);
-                    akt_z = akt_z -> nast_k;
-                }
-            }
+/*  Dopisuje na koniec zbioru 'z' wiersze zbioru 'zrodlo' od 'i' do 'j' 
+    (bez niego), które muszą leżeć za ostatnim wierszem 'z'.  */
+WEWNETRZNA void dopisz_wiersze(Tzywe* z, Tzywe* zrodlo, int i, int j) {
+    if (i == j) {
+        // Pusty zbiór może nie mieć jeszcze tablic.
+        return;
+    }
+    int n = ile_zywych(z);
+    int od = zrodlo -> pocz[i];
+    zarezerwuj(z, z -> ile_w + j - i, n + zrodlo -> pocz[j] - od);
+    memcpy(z -> w + z -> ile_w, zrodlo -> w + i, 
+           (size_t) (j - i) * sizeof(int));
+    memcpy(z -> k + n, zrodlo -> k + od, 
+           (size_t) (zrodlo -> pocz[j] - od) * sizeof(int));
+    for (int x = 1; x <= j - i; x++) {
+        z -> pocz[z -> ile_w + x] = n + zrodlo -> pocz[i + x] - od;
+    }
+    z -> ile_w += j - i;
+}
+
+/*  Dopisuje na koniec zbioru 'z' wszystkie wiersze zbioru 'zrodlo', które
+    muszą leżeć za ostatnim wierszem 'z'.  */
+WEWNETRZNA void dopisz_zywe(Tzywe* z, Tzywe* zrodlo) {
+    dopisz_wiersze(z, zrodlo, 0, zrodlo -> ile_w);
+}
+
+/*  Zapomina historię skrótów cyklu 'c' i sprawdzany w nim okres.  */
+WEWNETRZNA void zapomnij_skroty(Tcykl* c) {
+    for (int i = 0; i < ROZMIAR_HISTORII; i++) {
+        c -> historia[i].pokolenie = -1;
+    }
+    c -> kandydat = 0;
+}
+
+/*  Zapomina historię i wykryty okres cyklu 'c' i zeruje licznik 
+    generacji.  */
+WEWNETRZNA void wyczysc_cykl(Tcykl* c) {
+    c -> pokolenie = 0;
+    c -> okres = 0;
+    c -> dw = 0;
+    c -> dk = 0;
+    c -> bez_bitow = 0;
+    zapomnij_skroty(c);
+}
+
+/*  Inicjalizuje pustą historię cyklu 'c'.  */
+WEWNETRZNA void inicjalizuj_cykl(Tcykl* c) {
+    inicjalizuj_zywe(&(c -> kopia));
+    wyczysc_cykl(c);
+}
+
+/*  Zwalnia pamięć zarezerwowaną przez historię cyklu 'c'.  */
+WEWNETRZNA void zwolnij_cykl(Tcykl* c) {
+    zwolnij_zywe(&(c -> kopia));
+}
+
+/*  Inicjalizuje puste bufory 'b'.  */
+WEWNETRZNA void inicjalizuj_bufory(Tbufory* b) {
+    inicjalizuj_zywe(&(b -> gora));
+    inicjalizuj_zywe(&(b -> srodek));
+    inicjalizuj_zywe(&(b -> dol));
+    inicjalizuj_zywe(&(b -> nast));
+}
+
+/*  Zwalnia pamięć zarezerwowaną przez bufory 'b'.  */
+WEWNETRZNA void zwolnij_bufory(Tbufory* b) {
+    zwolnij_zywe(&(b -> gora));
+    zwolnij_zywe(&(b -> srodek));
+    zwolnij_zywe(&(b -> dol));
+    zwolnij_zywe(&(b -> nast));
+}
+
+/*  Przekazuje najmniejszą z liczb 'a', 'b' i 'c'.  */
+WEWNETRZNA int min3(int a, int b, int c) {
+    int m = a < b ? a : b;
+    return m < c ? m : c;
+}
+
+/*  Scala posortowane zbiory 'a', 'b' i 'c' w zbiór 'wynik' jednym liniowym
+    przejściem po wszystkich trzech naraz.  */
+WEWNETRZNA void scal_trzy(Tzywe* a, Tzywe* b, Tzywe* c, Tzywe* wynik) {
+    zarezerwuj(wynik, a -> ile_w + b -> ile_w + c -> ile_w,
+        ile_zywych(a) + ile_zywych(b) + ile_zywych(c));
+    wyczysc_zywe(wynik);
+    int ia = 0, ib = 0, ic = 0; // Bieżące wiersze w zbiorach.
+    int n = 0; // Liczba kolumn zapisanych w wyniku.
+    while (ia < a -> ile_w || ib < b -> ile_w || ic < c -> ile_w) {
+        int wa = ia < a -> ile_w ? a -> w[ia] : INT_MAX;
+        int wb = ib < b -> ile_w ? b -> w[ib] : INT_MAX;
+        int wc = ic < c -> ile_w ? c -> w[ic] : INT_MAX;
+        int w = min3(wa, wb, wc);
+        // Przedziały kolumn wiersza 'w' w każdym ze zbiorów (być może puste).
+        int pa = 0, ka = 0, pb = 0, kb = 0, pc = 0, kc = 0;
+        if (wa == w) {
+            pa = a -> pocz[ia];
+            ka = a -> pocz[++ia];
+        }
+        if (wb == w) {
+            pb = b -> pocz[ib];
+            kb = b -> pocz[++ib];
         }
-        akt_k = akt_k -> nast_k;
+        if (wc == w) {
+            pc = c -> pocz[ic];
+            kc = c -> pocz[++ic];
+        }
+        wynik -> w[wynik -> ile_w] = w;
+        while (pa < ka || pb < kb || pc < kc) {
+            int xa = pa < ka ? a -> k[pa] : INT_MAX;
+            int xb = pb < kb ? b -> k[pb] : INT_MAX;
+            int xc = pc < kc ? c -> k[pc] : INT_MAX;
+            int x = min3(xa, xb, xc);
+            wynik -> k[n++] = x;
+            pa += (xa == x);
+            pb += (xb == x);
+            pc += (xc == x);
+        }
+        zakoncz_wiersz(wynik, n);
     }
-    // Jeśli nie dodaliśmy żadnej kolumny, to zwalniamy niepotrzebny wiersz.
-    if (akt_z == kol_nowe_z) {
-        zwolnij_wiersze(&(z -> nast_w));
+}
+
+/*  Przekazuje położenie wiersza lub kolumny 'x' wewnątrz kafelka.  */
+WEWNETRZNA int w_kafelku(int x) {
+    return x & (BOK_KAFELKA - 1);
+}
+
+/*  Przekazuje numer kafelka, w którym leży wiersz lub kolumna 'x'.  */
+WEWNETRZNA int nr_kafelka(int x) {
+    return (x - w_kafelku(x)) / BOK_KAFELKA;
+}
+
+/*  Przekazuje miejsce w tablicy haszującej planszy 'p', od którego należy
+    szukać kafelka o współrzędnych 'w' i 'k'.  */
+WEWNETRZNA int skrot_kafelka(Tplansza* p, int w, int k) {
+    uint32_t x = (uint32_t) w * 0x9E3779B1u ^ (uint32_t) k * 0x85EBCA77u;
+    return (int) ((x ^ (x >> 15)) & (uint32_t) p -> maska);
+}
+
+/*  Wstawia kafelek 't' do tablicy haszującej planszy 'p', która musi mieć
+    na niego miejsce.  */
+WEWNETRZNA void wstaw_kafelek(Tplansza* p, Tkafelek* t) {
+    int h = skrot_kafelka(p, t -> w, t -> k);
+    while (p -> indeks[h].kafelek != NULL) {
+        h = (h + 1) & p -> maska;
     }
+    p -> indeks[h].w = t -> w;
+    p -> indeks[h].k = t -> k;
+    p -> indeks[h].kafelek = t;
 }
 
-/*  Sprawdza, czy za wskaźnik 'l' zostało coś dodane. Jeśli tak, przesuwa go
-    tak, aby pokazywał na dodany element.  */
-void przesun(Twiersze** l) {
-    if ((*l) -> nast_w != NULL) {
-        *l = (*l) -> nast_w;
+/*  Układa na nowo tablicę haszującą planszy 'p' tak, aby była wypełniona 
+    najwyżej w połowie.  */
+WEWNETRZNA void przelicz_indeks(Tplansza* p) {
+    int rozmiar = 16;
+    while (rozmiar < 2 * p -> ile) {
+        rozmiar *= 2;
+    }
+    if (rozmiar != p -> maska + 1) {
+        free(p -> indeks);
+        p -> indeks = (Tmiejsce*) malloc((size_t) rozmiar * sizeof(Tmiejsce));
+        assert(p -> indeks != NULL);
+        p -> maska = rozmiar - 1;
+    }
+    for (int i = 0; i < rozmiar; i++) {
+        p -> indeks[i].kafelek = NULL;
     }
+    for (int i = 0; i < p -> ile; i++) {
+        wstaw_kafelek(p, p -> kafelki[i]);
+    }
+}
+
+/*  Inicjalizuje pustą planszę 'p'.  */
+WEWNETRZNA void inicjalizuj_plansze(Tplansza* p) {
+    p -> ile = 0;
+    p -> poj = 0;
+    p -> kafelki = NULL;
+    p -> indeks = NULL;
+    p -> maska = -1;
+    p -> ostatni = NULL;
+    p -> stempel = 0;
+    przelicz_indeks(p);
 }
 
-/*  Tworzy listę żywych komórek w następnej generacji i przekazuje
-    wskaźnik do wyniku.  */
-Twiersze* nowe_zywe(char** stara, Twiersze* zywe_wiersze, Twymiary wymiary) {
-    Twiersze *gora, *srodek, *dol, *temp;
-    stworz_atrape_w(&gora);
-    stworz_atrape_w(&srodek);
-    stworz_atrape_w(&dol);
-    Twiersze* akt_g = gora;
-    Twiersze* akt_s = srodek;
-    Twiersze* akt_d = dol;
-    // Omijamy atrapę na liście żywych wierszy.
-    Twiersze* akt_w = zywe_wiersze -> nast_w;
-    while (akt_w != NULL) {
-        sprawdz_otoczenie(stara, -1, akt_w, akt_g, wymiary);
-        sprawdz_otoczenie(stara, 0, akt_w, akt_s, wymiary);
-        sprawdz_otoczenie(stara, 1, akt_w, akt_d, wymiary);
-        przesun(&akt_g);
-        przesun(&akt_s);
-        przesun(&akt_d);
-        akt_w = akt_w -> nast_w;
+/*  Zwalnia pamięć zarezerwowaną przez planszę 'p'.  */
+WEWNETRZNA void zwolnij_plansze(Tplansza* p) {
+    for (int i = 0; i < p -> ile; i++) {
+        free(p -> kafelki[i]);
     }
-    temp = scal_posort_w(gora, srodek);
-    return scal_posort_w(temp, dol);
+    free(p -> kafelki);
+    free(p -> indeks);
 }
 
-/*  Aktualizuje listę żywych wierszy w następnej generacji i odpowiednio zmienia
-    pola na planszy (rozszerza ją w miarę potrzeb).  */
-void nastepna_generacja(
-    char*** stara, 
-    Twiersze** zywe_wiersze, 
-    Twymiary* wymiary) {
+/*  Przekazuje kafelek planszy 'p' o współrzędnych 'w' i 'k' albo NULL, 
+    jeśli go nie ma.  */
+WEWNETRZNA Tkafelek* znajdz_kafelek(Tplansza* p, int w, int k) {
+    if (p -> ostatni != NULL && p -> ostatni -> w == w 
+        && p -> ostatni -> k == k) {
+        return p -> ostatni;
+    }
+    for (int h = skrot_kafelka(p, w, k); p -> indeks[h].kafelek != NULL; 
+         h = (h + 1) & p -> maska) {
+        if (p -> indeks[h].w == w && p -> indeks[h].k == k) {
+            p -> ostatni = p -> indeks[h].kafelek;
+            return p -> ostatni;
+        }
+    }
+    return NULL;
+}
 
-    Twiersze* zywe_wiersze_next = nowe_zywe(*stara, *zywe_wiersze, *wymiary);
-    ustaw(stara, *wymiary, *zywe_wiersze, MARTWA);
-    rozszerz_otoczenie(stara, wymiary, zywe_wiersze_next);
-    zwolnij_wiersze(zywe_wiersze);
-    *zywe_wiersze = zywe_wiersze_next;
+/*  Dodaje do planszy 'p' pusty kafelek o współrzędnych 'w' i 'k'
+    i przekazuje go.  */
+WEWNETRZNA Tkafelek* dodaj_kafelek(Tplansza* p, int w, int k) {
+    if (p -> ile == p -> poj) {
+        p -> poj = 2 * p -> poj + 16;
+        p -> kafelki = (Tkafelek**) realloc(
+            p -> kafelki, (size_t) p -> poj * sizeof(Tkafelek*));
+        assert(p -> kafelki != NULL);
+    }
+    Tkafelek* t = (Tkafelek*) calloc(1, sizeof(Tkafelek));
+    assert(t != NULL);
+    t -> w = w;
+    t -> k = k;
+    p -> kafelki[p -> ile++] = t;
+    if (2 * p -> ile > p -> maska + 1) {
+        przelicz_indeks(p);
+    }
+    else {
+        wstaw_kafelek(p, t);
+    }
+    p -> ostatni = t;
+    return t;
 }
 
-/*  Kieruje tym, co ma się wydarzyć w programie w zależności od otrzymanego
-    wejścia. Jeśli trzeba wyjść z programu, przekazuje 1, w przeciwnym
-    przypadku przekazuje 0.  */
-int wejscie(
-    char*** tab, 
-    Tokno* okno, 
-    Twymiary* wymiary, 
-    Twiersze** zywe_wiersze) {
-
-    int pierwszy = getchar();
-    ungetc(pierwszy, stdin);
-    switch (pierwszy) {
-        case KROPKA: // Zakończ program.
-            return 1;
-            break;
-        case SLASH: // Wczytaj początkową generację.
-            wczytaj_generacje(*zywe_wiersze);
-            rozszerz_otoczenie(tab, wymiary, *zywe_wiersze);
-            break;
-        case ENTER: // Obliczenie kolejnej generacji.
-            nastepna_generacja(tab, zywe_wiersze, wymiary);
-            break;
-        default:;
-            int a, b;
-            char c;
-            scanf("%d%c", &a, &c);
-            if (c == SPACJA) { // Przesuwanie okna.
-                scanf("%d", &b);
-                okno -> w = a;
-                okno -> k = b;
-                rozszerz_okno(tab, a, b, wymiary, *zywe_wiersze);
-            }
-            else if (c == ENTER) {
-                ungetc(ENTER, stdin);
-                if (a == 0) { // Zrzut bieżącej generacji.
-                    zrzut(*zywe_wiersze);
-                }
-                else { // Obliczenie 'a' kolejnych generacji.
-                    for (int i = 0; i < a; i++) {
-                        nastepna_generacja(tab, zywe_wiersze, wymiary);
-                    }
-                }
-            }
+/*  Przekazuje wskaźnik na pole planszy 'p' w wierszu 'w' i kolumnie 'k'
+    albo NULL, jeśli to pole leży poza kafelkami (jest więc martwe).  */
+WEWNETRZNA char* pole(Tplansza* p, int w, int k) {
+    int tw = nr_kafelka(w), tk = nr_kafelka(k);
+    Tkafelek* t = znajdz_kafelek(p, tw, tk);
+    if (t == NULL) {
+        return NULL;
     }
-    return 0;
+    return &(t -> pola[w_kafelku(w)][w_kafelku(k)]);
 }
 
-int main(void) {
-    // Inicjalizacja planszy.
-    char** plansza;
-    inicjalizuj(&plansza, WIERSZE, KOLUMNY);
-    // Inicjalizacja zmiennych.
-    // Lista wszystkich żywych komórek w bieżącej generacji.
-    Twiersze* zywe_wiersze;
-    // Tworzenie atrapy.
-    stworz_atrape_w(&zywe_wiersze);
-    // Bieżące okno.
-    Tokno okno;
-    okno.w = 1;
-    okno.k = 1;
-    // Bieżące wymiary planszy.
-    Twymiary wymiary;
-    wymiary.m = WIERSZE;
-    wymiary.n = KOLUMNY;
-    wymiary.min_w = 1;
-    wymiary.min_k = 1;
-    wymiary.max_w = WIERSZE;
-    wymiary.max_k = KOLUMNY;
-    // Główna pętla programu.
-    while (!wejscie(&plansza, &okno, &wymiary, &zywe_wiersze)) {
-        wypisz_okno(plansza, okno, wymiary);
-        wyczysc_strumien();
+/*  Przekazuje wskaźnik na pole planszy 'p' w wierszu 'w' i kolumnie 'k', 
+    w razie potrzeby tworząc kafelek, w którym ono leży.  */
+WEWNETRZNA char* nowe_pole(Tplansza* p, int w, int k) {
+    int tw = nr_kafelka(w), tk = nr_kafelka(k);
+    Tkafelek* t = znajdz_kafelek(p, tw, tk);
+    if (t == NULL) {
+        t = dodaj_kafelek(p, tw, tk);
     }
-    // Zwalnianie pamięci.
-    zwolnij_2D(plansza, wymiary);
-    zwolnij_wiersze(&zywe_wiersze);
-    return 0;
+    t -> stempel = p -> stempel;
+    return &(t -> pola[w_kafelku(w)][w_kafelku(k)]);
 }
+
+/*  Ustawia otoczenie 'o' wokół kafelka planszy 'p' o współrzędnych 'w' 
+    i 'k'.  */
+WEWNETRZNA void ustaw_otoczenie(Totoczenie* o, Tplansza* p, int w, int k) {
+    o -> p = p;
+    o -> w = w;
+    o -> k = k;
+    o -> kafelki[1][1] = znajdz_kafelek(p, w, k);
+    o -> znane = 1 << 4;
+}
+
+/*  Przekazuje kafelek otoczenia 'o' leżący w wierszu 'a' i kolumnie 'b'
+    (licząc od zera) albo NULL, jeśli go nie ma.  */
+WEWNETRZNA Tkafelek* sasiedni(Totoczenie* o, int a, int b) {
+    int bit = 1 << (3 * a + b);
+    if ((o -> znane & bit) == 0) {
+        o -> kafelki[a][b] = 
+            znajdz_kafelek(o -> p, o -> w + a - 1, o -> k + b - 1);
+        o -> znane |= bit;
+    }
+    return o -> kafelki[a][b];
+}
+
+/*  Ustawia pola planszy reprezentowane w zbiorze 'zywe' na znak 'jak'. 
+    Pola te muszą leżeć na istniejących kafelkach.  */
+WEWNETRZNA void ustaw(Tplansza* p, Tzywe* zywe, char jak) {
+    for (int i = 0; i < zywe -> ile_w; i++) {
+        for (int j = zywe -> pocz[i]; j < zywe -> pocz[i + 1]; j++) {
+            *pole(p, zywe -> w[i], zywe -> k[j]) = jak;
+        }
+    }
+}
+
+/*  Ustawia komórki ze zbioru 'zywe' na planszy 'p' jako żywe, tworząc 
+    brakujące kafelki, i zwalnia kafelki, na których nie została żadna 
+    żywa komórka. Pozostałe pola planszy muszą być już martwe.  */
+WEWNETRZNA void umiesc_zywe(Tplansza* p, Tzywe* zywe) {
+    p -> stempel++;
+    for (int i = 0; i < zywe -> ile_w; i++) {
+        for (int j = zywe -> pocz[i]; j < zywe -> pocz[i + 1]; j++) {
+            *nowe_pole(p, zywe -> w[i], zywe -> k[j]) = ZYWA;
+        }
+    }
+    // Kafelki bez aktualnego stempla nie zawierają żywych komórek.
+    int ile = 0;
+    for (int i = 0; i < p -> ile; i++) {
+        if (p -> kafelki[i] -> stempel != p -> stempel) {
+            free(p -> kafelki[i]);
+        }
+        else {
+            p -> kafelki[ile++] = p -> kafelki[i];
+        }
+    }
+    if (ile != p -> ile) {
+        p -> ile = ile;
+        p -> ostatni = NULL;
+        przelicz_indeks(p);
+    }
+    // Tablica kafelków maleje, gdy wzór wymarł lub skurczył się, ale 
+    // z zapasem, aby nie zmieniała się przy każdym wahnięciu wzoru.
+    if (p -> poj > 16 && 4 * p -> ile < p -> poj) {
+        p -> poj = 2 * p -> ile + 16;
+        p -> kafelki = (Tkafelek**) realloc(
+            p -> kafelki, (size_t) p -> poj * sizeof(Tkafelek*));
+        assert(p -> kafelki != NULL);
+    }
+}
+
+/*  Przekazuje najmniejszy indeks 'i' z przedziału od 'od' do 'do_' (bez 
+    niego) rosnącej tablicy 't', dla którego 't[i] >= x', albo 'do_', jeśli
+    takiego nie ma.  */
+WEWNETRZNA int pierwszy_niemniejszy(int* t, int od, int do_, int x) {
+    while (od < do_) {
+        int s = od + (do_ - od) / 2;
+        if (t[s] < x) {
+            od = s + 1;
+        }
+        else {
+            do_ = s;
+        }
+    }
+    return od;
+}
+
+/*  Inicjalizuje pusty bufor wyjścia 'p' wypisywany do pliku 'plik'.  */
+WEWNETRZNA void inicjalizuj_pisarza(Tpisarz* p, FILE* plik) {
+    p -> poj = ROZMIAR_PISARZA;
+    p -> bufor = (char*) malloc(p -> poj);
+    assert(p -> bufor != NULL);
+    p -> ile = 0;
+    p -> plik = plik;
+    p -> potok = NULL;
+}
+
+/*  Wątek potoku 'dane': zapisuje do pliku kolejne bufory z kolejki 
+    i oddaje je wątkowi głównemu. Plik jest opróżniany, gdy kolejka jest
+    pusta, więc w pracy interaktywnej wynik polecenia pojawia się od razu.
+    Kończy się, gdy kolejka jest pusta, a potok ma się zakończyć.  */
+WEWNETRZNA void* wypisuj_potok(void* dane) {
+    Tpotok* t = (Tpotok*) dane;
+    pthread_mutex_lock(&(t -> zamek));
+    while (1) {
+        while (t -> ile_pelnych == 0 && !t -> koniec) {
+            pthread_cond_wait(&(t -> pelny), &(t -> zamek));
+        }
+        if (t -> ile_pelnych == 0) {
+            break;
+        }
+        Tbufor_potoku b = t -> pelne[t -> pocz];
+        pthread_mutex_unlock(&(t -> zamek));
+        fwrite(b.bufor, 1, b.ile, t -> plik);
+        pthread_mutex_lock(&(t -> zamek));
+        t -> pocz = (t -> pocz + 1) % BUFORY_POTOKU;
+        t -> ile_pelnych--;
+        t -> wolne[t -> ile_wolnych++] = b;
+        pthread_cond_signal(&(t -> wolny));
+        if (t -> ile_pelnych == 0) {
+            pthread_mutex_unlock(&(t -> zamek));
+            fflush(t -> plik);
+            pthread_mutex_lock(&(t -> zamek));
+        }
+    }
+    pthread_mutex_unlock(&(t -> zamek));
+    return NULL;
+}
+
+/*  Uruchamia potok 't', przez który zawartość bufora 'p' będzie 
+    zapisywana do jego pliku w osobnym wątku.  */
+WEWNETRZNA void uruchom_potok(Tpotok* t, Tpisarz* p) {
+    t -> plik = p -> plik;
+    t -> pocz = 0;
+    t -> ile_pelnych = 0;
+    t -> koniec = 0;
+    // Jeden bufor ma pisarz, pozostałe czekają na wypełnienie.
+    t -> ile_wolnych = BUFORY_POTOKU - 1;
+    for (int i = 0; i < t -> ile_wolnych; i++) {
+        t -> wolne[i].poj = p -> poj;
+        t -> wolne[i].bufor = (char*) malloc(p -> poj);
+        assert(t -> wolne[i].bufor != NULL);
+    }
+    pthread_mutex_init(&(t -> zamek), NULL);
+    pthread_cond_init(&(t -> pelny), NULL);
+    pthread_cond_init(&(t -> wolny), NULL);
+    int blad = pthread_create(&(t -> watek), NULL, wypisuj_potok, t);
+    assert(blad == 0);
+    (void) blad;
+    p -> potok = t;
+}
+
+/*  Czeka, aż wątek potoku 't' zapisze wszystkie bufory, kończy go 
+    i zwalnia bufory.  */
+WEWNETRZNA void zatrzymaj_potok(Tpotok* t) {
+    pthread_mutex_lock(&(t -> zamek));
+    t -> koniec = 1;
+    pthread_cond_signal(&(t -> pelny));
+    pthread_mutex_unlock(&(t -> zamek));
+    pthread_join(t -> watek, NULL);
+    for (int i = 0; i < t -> ile_wolnych; i++) {
+        free(t -> wolne[i].bufor);
+    }
+    pthread_mutex_destroy(&(t -> zamek));
+    pthread_cond_destroy(&(t -> pelny));
+    pthread_cond_destroy(&(t -> wolny));
+}
+
+/*  Wypisuje zawartość bufora 'p' jednym wywołaniem 'fwrite' i opróżnia 
+    go. Jeśli bufor ma potok, przekazuje go wątkowi potoku i bierze od 
+    niego wolny bufor.  */
+WEWNETRZNA void oproznij(Tpisarz* p) {
+    if (p -> ile > 0 && p -> potok != NULL) {
+        Tpotok* t = p -> potok;
+        pthread_mutex_lock(&(t -> zamek));
+        while (t -> ile_wolnych == 0) {
+            pthread_cond_wait(&(t -> wolny), &(t -> zamek));
+        }
+        Tbufor_potoku* b = &(t -> pelne[(t -> pocz + t -> ile_pelnych) 
+                                        % BUFORY_POTOKU]);
+        b -> bufor = p -> bufor;
+        b -> ile = p -> ile;
+        b -> poj = p -> poj;
+        t -> ile_pelnych++;
+        Tbufor_potoku wolny = t -> wolne[--t -> ile_wolnych];
+        pthread_cond_signal(&(t -> pelny));
+        pthread_mutex_unlock(&(t -> zamek));
+        p -> bufor = wolny.bufor;
+        p -> poj = wolny.poj;
+        p -> ile = 0;
+    }
+    else if (p -> ile > 0 && p -> plik != NULL) {
+        fwrite(p -> bufor, 1, p -> ile, p -> plik);
+        p -> ile = 0;
+    }
+}
+
+/*  Wypisuje zawartość bufora 'p' i zwalnia jego pamięć.  */
+WEWNETRZNA void zwolnij_pisarza(Tpisarz* p) {
+    oproznij(p);
+    if (p -> plik != NULL) {
+        fflush(p -> plik);
+    }
+    free(p -> bufor);
+}
+
+/*  Dba o to, aby w buforze 'p' zmieściło się jeszcze 'n' znaków 
+    i przekazuje wskaźnik na miejsce na nie. Znaki trzeba potem dopisać 
+    funkcją 'dopisane'.  */
+WEWNETRZNA char* miejsce_w_buforze(Tpisarz* p, size_t n) {
+    if (p -> ile + n > p -> poj && p -> plik == NULL) {
+        while (p -> ile + n > p -> poj) {
+            p -> poj *= 2;
+        }
+        p -> bufor = (char*) realloc(p -> bufor, p -> poj);
+        assert(p -> bufor != NULL);
+    }
+    else if (p -> ile + n > p -> poj) {
+        oproznij(p);
+        if (n > p -> poj) {
+            free(p -> bufor);
+            p -> poj = n;
+            p -> bufor = (char*) malloc(p -> poj);
+            assert(p -> bufor != NULL);
+        }
+    }
+    return p -> bufor + p -> ile;
+}
+
+/*  Zalicza do zawartości bufora 'p' kolejne 'n' znaków zapisanych 
+    w miejscu przekazanym przez 'miejsce_w_buforze'.  */
+WEWNETRZNA void dopisane(Tpisarz* p, size_t n) {
+    p -> ile += n;
+}
+
+/*  Dopisuje do bufora 'p' znak 'znak'.  */
+WEWNETRZNA void wypisz_znak(Tpisarz* p, char znak) {
+    *miejsce_w_buforze(p, 1) = znak;
+    dopisane(p, 1);
+}
+
+/*  Dopisuje do bufora 'p' napis 'tekst'.  */
+WEWNETRZNA void wypisz_tekst(Tpisarz* p, const char* tekst) {
+    size_t n = strlen(tekst);
+    memcpy(miejsce_w_buforze(p, n), tekst, n);
+    dopisane(p, n);
+}
+
+/*  Dopisuje do bufora 'p' znak 'przed' i liczbę 'x' zapisaną dziesiętnie.
+    Cyfry powstają parami, od końca, na podstawie tablicy dwucyfrowych 
+    liczb.  */
+WEWNETRZNA void wypisz_liczbe(Tpisarz* p, char przed, long long x) {
+    static const char pary[] = 
+        "00010203040506070809101112131415161718192021222324252627282930313233"
+        "34353637383940414243444546474849505152535455565758596061626364656667"
+        "6869707172737475767778798081828384858687888990919293949596979899";
+    char cyfry[24];
+    int n = sizeof(cyfry);
+    unsigned long long u = x < 0 ? 0ULL - (unsigned long long) x 
+                           : (unsigned long long) x;
+    while (u >= 100) {
+        int para = (int) (u % 100);
+        u /= 100;
+        cyfry[--n] = pary[2 * para + 1];
+        cyfry[--n] = pary[2 * para];
+    }
+    if (u >= 10) {
+        cyfry[--n] = pary[2 * u + 1];
+        cyfry[--n] = pary[2 * u];
+    }
+    else {
+        cyfry[--n] = (char) ('0' + u);
+    }
+    if (x < 0) {
+        cyfry[--n] = '-';
+    }
+    size_t dlugosc = sizeof(cyfry) - (size_t) n + 1;
+    char* m = miejsce_w_buforze(p, dlugosc);
+    m[0] = przed;
+    memcpy(m + 1, cyfry + n, dlugosc - 1);
+    dopisane(p, dlugosc);
+}
+
+/*  Rezerwuje w buforze 'p' miejsce na całe okno wraz z linią kończącą je,
+    wypełnia je martwymi komórkami i przekazuje wskaźnik na jego początek.
+    Komórka z wiersza 'i' i kolumny 'j' okna leży pod indeksem 
+    'i * SZEROKOSC_EKRANU + j'.  */
+WEWNETRZNA char* nowy_ekran(Tpisarz* p) {
+    size_t rozmiar = (size_t) (WIERSZE + 1) * SZEROKOSC_EKRANU;
+    char* ekran = miejsce_w_buforze(p, rozmiar);
+    memset(ekran, KROPKA, rozmiar - SZEROKOSC_EKRANU);
+    memset(ekran + rozmiar - SZEROKOSC_EKRANU, ROWNASIE, KOLUMNY);
+    for (int i = 0; i <= WIERSZE; i++) {
+        ekran[i * SZEROKOSC_EKRANU + KOLUMNY] = ENTER;
+    }
+    dopisane(p, rozmiar);
+    return ekran;
+}
+
+/*  Wypisuje okno zadane przez 'okno' o 'WIERSZE' wierszach 
+    i 'KOLUMNY' kolumnach do bufora 'p' na podstawie zbioru żywych komórek
+    'zywe'. Wiersze i kolumny okna są wyszukiwane binarnie, więc koszt nie 
+    zależy od tego, jak daleko leży okno.  */
+WEWNETRZNA void wypisz_okno(Tpisarz* p, Tzywe* zywe, Tokno okno) {
+    char* ekran = nowy_ekran(p);
+    long long dol = (long long) okno.w + WIERSZE;
+    long long prawa = (long long) okno.k + KOLUMNY;
+    for (int i = pierwszy_niemniejszy(zywe -> w, 0, zywe -> ile_w, okno.w); 
+         i < zywe -> ile_w && zywe -> w[i] < dol; i++) {
+        int j = pierwszy_niemniejszy(
+            zywe -> k, zywe -> pocz[i], zywe -> pocz[i + 1], okno.k);
+        for (; j < zywe -> pocz[i + 1] && zywe -> k[j] < prawa; j++) {
+            ekran[(zywe -> w[i] - okno.w) * SZEROKOSC_EKRANU 
+                  + (zywe -> k[j] - okno.k)] = ZYWA;
+        }
+    }
+}
+
+/*  Przekazuje klucz komórki w wierszu 'w' i kolumnie 'k', którego porządek
+    jako liczby bez znaku zgadza się z porządkiem wierszy i kolumn.  */
+WEWNETRZNA uint64_t klucz_komorki(int w, int k) {
+    return ((uint64_t) ((uint32_t) w ^ 0x80000000u) << 32) 
+           | ((uint32_t) k ^ 0x80000000u);
+}
+
+/*  Sortuje pozycyjnie 'n' kluczy z tablicy 't', używając tablicy 'pom' tego
+    samego rozmiaru. Przebiegi, w których wszystkie klucze mają tę samą 
+    cyfrę, są pomijane. Przekazuje tablicę, w której leży wynik.  */
+WEWNETRZNA uint64_t* sortuj_pozycyjnie(uint64_t* t, uint64_t* pom, size_t n) {
+    size_t* ile = (size_t*) malloc(((size_t) 1 << 16) * sizeof(size_t));
+    assert(ile != NULL);
+    for (int przesuniecie = 0; przesuniecie < 64; przesuniecie += 16) {
+        memset(ile, 0, ((size_t) 1 << 16) * sizeof(size_t));
+        for (size_t i = 0; i < n; i++) {
+            ile[(t[i] >> przesuniecie) & 0xFFFF]++;
+        }
+        if (ile[(t[0] >> przesuniecie) & 0xFFFF] == n) {
+            continue;
+        }
+        size_t suma = 0;
+        for (size_t c = 0; c < ((size_t) 1 << 16); c++) {
+            size_t x = ile[c];
+            ile[c] = suma;
+            suma += x;
+        }
+        for (size_t i = 0; i < n; i++) {
+            pom[ile[(t[i] >> przesuniecie) & 0xFFFF]++] = t[i];
+        }
+        uint64_t* temp = t;
+        t = pom;
+        pom = temp;
+    }
+    free(ile);
+    return t;
+}
+
+/*  Porządkuje zbiór 'z', w którym wiersze i kolumny mogą być w dowolnej 
+    kolejności i mogą się powtarzać: sortuje komórki pozycyjnie, usuwa 
+    powtórzenia i układa zbiór na nowo.  */
+WEWNETRZNA void uporzadkuj_zywe(Tzywe* z) {
+    size_t n = (size_t) ile_zywych(z);
+    if (n == 0) {
+        return;
+    }
+    uint64_t* klucze = (uint64_t*) malloc(n * sizeof(uint64_t));
+    uint64_t* pom = (uint64_t*) malloc(n * sizeof(uint64_t));
+    assert(klucze != NULL && pom != NULL);
+    for (int i = 0; i < z -> ile_w; i++) {
+        for (int j = z -> pocz[i]; j < z -> pocz[i + 1]; j++) {
+            klucze[j] = klucz_komorki(z -> w[i], z -> k[j]);
+        }
+    }
+    uint64_t* wynik = sortuj_pozycyjnie(klucze, pom, n);
+    // Wierszy jest co najwyżej tyle, ile było ich przed porządkowaniem.
+    wyczysc_zywe(z);
+    int m = 0; // Liczba kolumn zapisanych w zbiorze.
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0 && wynik[i] == wynik[i - 1]) {
+            continue;
+        }
+        int w = (int) ((uint32_t) (wynik[i] >> 32) ^ 0x80000000u);
+        if (z -> ile_w == 0 || z -> w[z -> ile_w - 1] != w) {
+            z -> w[z -> ile_w] = w;
+            z -> pocz[z -> ile_w + 1] = m;
+            z -> ile_w++;
+        }
+        z -> k[m++] = (int) ((uint32_t) wynik[i] ^ 0x80000000u);
+        z -> pocz[z -> ile_w] = m;
+    }
+    free(klucze);
+    free(pom);
+}
+
+/*  Wczytuje z czytnika 'c' żywe wiersze i żywe kolumny w początkowej 
+    generacji do pustego zbioru 'zywe_wiersze'. Wiersze i kolumny mogą być 
+    nieuporządkowane i mogą się powtarzać.  */
+WEWNETRZNA void wczytaj_generacje(Tczytnik* c, Tzywe* zywe_wiersze) {
+    int w, k;
+    int n = 0; // Liczba wczytanych kolumn.
+    int posortowane = 1; // Czy dotąd wszystko było rosnąco.
+    int koniec = 0; // Flaga oznaczająca koniec wczytywania.
+    while (!koniec) {
+        pobierz(c); // Pomiń pierwszy slash.
+        if (!wczytaj_liczbe(c, &w)) {
+            koniec = 1;
+        }
+        else {
+            zarezerwuj(zywe_wiersze, zywe_wiersze -> ile_w + 1, n);
+            if (zywe_wiersze -> ile_w > 0 
+                && zywe_wiersze -> w[zywe_wiersze -> ile_w - 1] >= w) {
+                posortowane = 0;
+            }
+            zywe_wiersze -> w[zywe_wiersze -> ile_w] = w;
+            // Wczytywanie żywych kolumn w wierszu 'w'.
+            int poprzednia = INT_MIN;
+            int znak;
+            while ((znak = podejrzyj(c)) != ENTER && znak != EOF) {
+                if (!wczytaj_liczbe(c, &k)) {
+                    if (podejrzyj(c) != ENTER) {
+                        pobierz(c); // Pomiń znak, który nie jest liczbą.
+                    }
+                    continue;
+                }
+                if (n == zywe_wiersze -> poj_k) {
+                    zarezerwuj(zywe_wiersze, zywe_wiersze -> ile_w + 1, 
+                               n + 1);
+                }
+                zywe_wiersze -> k[n++] = k;
+                if (k <= poprzednia) {
+                    posortowane = 0;
+                }
+                poprzednia = k;
+            }
+            pobierz(c); // Pomiń koniec wiersza.
+            // Jeśli nie dodaliśmy żadnej kolumny, wiersz zostanie pominięty.
+            zakoncz_wiersz(zywe_wiersze, n);
+        }
+    }
+    if (!posortowane) {
+        uporzadkuj_zywe(zywe_wiersze);
+    }
+}
+
+/*  Wczytuje z czytnika 'c' wzór w formacie RLE do pustego zbioru 
+    'zywe_wiersze', tak aby jego lewy górny róg leżał w wierszu 'w' 
+    i kolumnie 'k'. Wiersze komentarzy (od '#') i nagłówek (od 'x') są 
+    pomijane, a wczytywanie kończy się na znaku '!', po którym reszta 
+    wiersza zostaje w czytniku.  */
+WEWNETRZNA void wczytaj_rle(Tczytnik* c, Tzywe* zywe_wiersze, int w, int k) {
+    int znak;
+    while ((znak = podejrzyj(c)) == '#' || znak == 'x') {
+        wyczysc_strumien(c);
+    }
+    int n = 0; // Liczba wczytanych kolumn.
+    int kolumna = k;
+    zarezerwuj(zywe_wiersze, 1, 0);
+    zywe_wiersze -> w[0] = w;
+    while ((znak = podejrzyj(c)) != '!' && znak != EOF) {
+        int ile = 1;
+        if (znak >= '0' && znak <= '9') {
+            wczytaj_liczbe(c, &ile);
+            znak = podejrzyj(c);
+        }
+        pobierz(c);
+        if (znak == 'b' || znak == KROPKA) {
+            kolumna += ile;
+        }
+        else if (znak == '$') {
+            zakoncz_wiersz(zywe_wiersze, n);
+            zarezerwuj(zywe_wiersze, zywe_wiersze -> ile_w + 1, n);
+            w += ile;
+            kolumna = k;
+            zywe_wiersze -> w[zywe_wiersze -> ile_w] = w;
+        }
+        else if (znak >= 'A' && znak <= 'z') { // Żywa komórka.
+            zarezerwuj(zywe_wiersze, zywe_wiersze -> ile_w + 1, n + ile);
+            for (int i = 0; i < ile; i++) {
+                zywe_wiersze -> k[n++] = kolumna++;
+            }
+        }
+    }
+    pobierz(c); // Pomiń wykrzyknik.
+    zakoncz_wiersz(zywe_wiersze, n);
+}
+
+/*  Wypisuje do bufora 'p' wiersze zbioru 'zywe_wiersze' w postaci 
+    używanej przez zrzut.  */
+WEWNETRZNA void wypisz_wiersze(Tpisarz* p, Tzywe* zywe_wiersze) {
+    for (int i = 0; i < zywe_wiersze -> ile_w; i++) {
+        wypisz_liczbe(p, SLASH, zywe_wiersze -> w[i]);
+        for (int j = zywe_wiersze -> pocz[i]; j < zywe_wiersze -> pocz[i + 1];
+             j++) {
+            wypisz_liczbe(p, SPACJA, zywe_wiersze -> k[j]);
+        }
+        wypisz_znak(p, ENTER);
+    }
+}
+
+/*  Wypisuje stan aktualnej generacji.  */
+WEWNETRZNA void zrzut(Tpisarz* p, Tzywe* zywe_wiersze) {
+    wypisz_wiersze(p, zywe_wiersze);
+    wypisz_znak(p, SLASH);
+    wypisz_znak(p, ENTER);
+}
+
+/*  Przekazuje wskaźnik na pole w wierszu 'w' i kolumnie 'k' liczonych 
+    względem środkowego kafelka otoczenia 'o' (od -BOK_KAFELKA do 
+    2 * BOK_KAFELKA - 1) albo NULL, jeśli to pole leży poza kafelkami.  */
+WEWNETRZNA char* pole_otoczenia(Totoczenie* o, int w, int k) {
+    Tkafelek* t = sasiedni(o, w < 0 ? 0 : (w < BOK_KAFELKA ? 1 : 2),
+                              k < 0 ? 0 : (k < BOK_KAFELKA ? 1 : 2));
+    return t == NULL ? NULL : &(t -> pola[w_kafelku(w)][w_kafelku(k)]);
+}
+
+/*  Przekazuje 1, jeśli według reguły 'regula' komórka żywa (gdy 'zywa' 
+    jest niezerowe) albo martwa z 'n' żywymi sąsiadami jest żywa 
+    w następnej generacji, a w przeciwnym przypadku 0.  */
+WEWNETRZNA int wedlug_reguly(int regula, int zywa, int n) {
+    return (regula >> (n + (zywa ? PRZEZYCIE : 0))) & 1;
+}
+
+/*  Sprawdza, czy komórka w wierszu 'w' i kolumnie 'k' liczonych względem
+    środkowego kafelka otoczenia 'o' powinna być żywa w następnej generacji.
+    Jeśli tak, funkcja zwraca wartość '1', jeśli nie albo jeśli komórka 
+    była już sprawdzona, zwraca '0'. Co więcej, jeśli komórka powinna być 
+    żywa, zaznacza ten fakt na planszy (w razie potrzeby dokładając 
+    kafelek), aby uniknąć niepotrzebnego ponownego sprawdzania. O losie 
+    komórki decyduje reguła 'regula'.  */
+WEWNETRZNA int sprawdz(Totoczenie* o, int w, int k, int regula) {
+    char komorka; // Rozważana komórka.
+    int ile_zywych = 0;
+    Tkafelek* t = o -> kafelki[1][1];
+    // Zwykle komórka i wszyscy jej sąsiedzi leżą na środkowym kafelku.
+    int wnetrze = t != NULL && w > 0 && w < BOK_KAFELKA - 1 
+                  && k > 0 && k < BOK_KAFELKA - 1;
+    char* x = wnetrze ? &(t -> pola[w][k]) : pole_otoczenia(o, w, k);
+    char stan = x == NULL ? MARTWA : *x;
+    if (stan != ZYWA && stan != MARTWA) {
+        return 0;
+    }
+    // Zliczanie żywych sąsiadów.
+    if (wnetrze) {
+        for (int i = -1; i < 2; i++) {
+            for (int j = -1; j < 2; j++) {
+                komorka = t -> pola[w + i][k + j];
+                if (komorka == ZYWA || komorka == ODWIEDZONA_ZYWA) {
+                    ile_zywych++;
+                }
+            }
+        }
+    }
+    else {
+        for (int i = -1; i < 2; i++) {
+            for (int j = -1; j < 2; j++) {
+                char* s = pole_otoczenia(o, w + i, k + j);
+                komorka = s == NULL ? MARTWA : *s;
+                if (komorka == ZYWA || komorka == ODWIEDZONA_ZYWA) {
+                    ile_zywych++;
+                }
+            }
+        }
+    }
+    switch (stan) {
+        case ZYWA:
+            ile_zywych--; // Wtedy policzyliśmy o jedną żywą za dużo.
+            *x = ODWIEDZONA_ZYWA;
+            if (wedlug_reguly(regula, 1, ile_zywych)) {
+                return 1;
+            }
+            break;
+        case MARTWA:
+            if (wedlug_reguly(regula, 0, ile_zywych)) {
+                if (x == NULL) {
+                    x = nowe_pole(o -> p, o -> w * BOK_KAFELKA + w, 
+                                  o -> k * BOK_KAFELKA + k);
+                    // Otoczenie nie zna jeszcze nowego kafelka.
+                    ustaw_otoczenie(o, o -> p, o -> w, o -> k);
+                }
+                *x = ODWIEDZONA_MARTWA;
+                return 1;
+            }
+            break;
+        default: assert(0); // Błąd.
+    }
+    return 0;
+}
+
+/*  Sprawdza, czy komórki sąsiadujące z żywymi komórkami w wierszu 'i' 
+    zbioru 'zywe' powinny być żywe w następnej generacji. Komórki, które 
+    powinny być żywe, są dopisywane na koniec zbiorów 'b -> gora', 
+    'b -> srodek' i 'b -> dol' (odpowiednio z wiersza nad, tego samego 
+    i pod), które muszą mieć na nie miejsce. Generacja jest liczona według
+    reguły 'regula'.  */
+WEWNETRZNA void sprawdz_otoczenie(Tplansza* stara, Tzywe* zywe, int i, 
+    Tbufory* b, int regula) {
+
+    Tzywe* z[3] = {&(b -> gora), &(b -> srodek), &(b -> dol)};
+    int n[3]; // Końce kolumn w zbiorach 'z'.
+    for (int offset = 0; offset < 3; offset++) {
+        n[offset] = z[offset] -> pocz[z[offset] -> ile_w];
+    }
+    int tw = nr_kafelka(zywe -> w[i]), lw = w_kafelku(zywe -> w[i]);
+    // Otoczenie kafelka bieżącej kolumny; kolejne kolumny zwykle leżą na
+    // tym samym kafelku.
+    int tk = INT_MIN;
+    Totoczenie o;
+    for (int j = zywe -> pocz[i]; j < zywe -> pocz[i + 1]; j++) {
+        int kolumna = zywe -> k[j];
+        if (nr_kafelka(kolumna) != tk) {
+            tk = nr_kafelka(kolumna);
+            ustaw_otoczenie(&o, stara, tw, tk);
+        }
+        int lk = w_kafelku(kolumna);
+        for (int offset = -1; offset < 2; offset++) {
+            for (int d = -1; d < 2; d++) {
+                if (sprawdz(&o, lw + offset, lk + d, regula)) {
+                    z[offset + 1] -> k[n[offset + 1]++] = kolumna + d;
+                }
+            }
+        }
+    }
+    // Jeśli nie dodaliśmy żadnej kolumny, to wiersz zostanie pominięty.
+    for (int offset = -1; offset < 2; offset++) {
+        z[offset + 1] -> w[z[offset + 1] -> ile_w] = (zywe -> w[i]) + offset;
+        zakoncz_wiersz(z[offset + 1], n[offset + 1]);
+    }
+}
+
+/*  Tworzy zbiór żywych komórek w następnej generacji w buforze 'b -> nast'. 
+    Kandydaci z wierszy nad, w i pod żywymi wierszami trafiają do osobnych
+    buforów, bo każdy z nich jest wtedy posortowany, a na końcu te trzy 
+    bufory są scalane. Generacja jest liczona według reguły 'regula'.  */
+WEWNETRZNA void nowe_zywe(Tbufory* b, Tplansza* stara, Tzywe* zywe, 
+    int regula) {
+
+    // Każda żywa komórka daje co najwyżej trzech kandydatów w każdym buforze.
+    int kolumny = 3 * ile_zywych(zywe);
+    zarezerwuj(&(b -> gora), zywe -> ile_w, kolumny);
+    zarezerwuj(&(b -> srodek), zywe -> ile_w, kolumny);
+    zarezerwuj(&(b -> dol), zywe -> ile_w, kolumny);
+    wyczysc_zywe(&(b -> gora));
+    wyczysc_zywe(&(b -> srodek));
+    wyczysc_zywe(&(b -> dol));
+    for (int i = 0; i < zywe -> ile_w; i++) {
+        sprawdz_otoczenie(stara, zywe, i, b, regula);
+    }
+    scal_trzy(&(b -> gora), &(b -> srodek), &(b -> dol), &(b -> nast));
+}
+
+/*  Dopisuje na koniec zbioru 'z' wiersz 'r' następnej generacji. 'ia', 'ib'
+    i 'ic' to numery wierszy 'r - 1', 'r' i 'r + 1' w zbiorze 'zywe' albo
+    -1, jeśli tych wierszy nie ma. Plansza nie jest potrzebna: kandydaci 
+    i ich sąsiedzi są wyznaczani jednym przejściem po trzech posortowanych 
+    wierszach, a zbiór 'z' musi mieć miejsce na wynik. Generacja jest 
+    liczona według reguły 'regula'.  */
+WEWNETRZNA void policz_wiersz(Tzywe* zywe, int r, int ia, int ib, int ic, 
+    Tzywe* z, int regula) {
+
+    int wiersze[3] = {ia, ib, ic};
+    int p[3], kon[3]; // Bieżące położenia i końce kolumn wierszy.
+    int c = INT_MAX; // Bieżący kandydat.
+    for (int x = 0; x < 3; x++) {
+        p[x] = wiersze[x] < 0 ? 0 : zywe -> pocz[wiersze[x]];
+        kon[x] = wiersze[x] < 0 ? 0 : zywe -> pocz[wiersze[x] + 1];
+        if (p[x] < kon[x] && zywe -> k[p[x]] < c) {
+            c = zywe -> k[p[x]];
+        }
+    }
+    int n = z -> pocz[z -> ile_w];
+    c--;
+    for (;;) {
+        int ile_zywych = 0, zywa = 0;
+        int nastepna = INT_MAX; // Najmniejsza kolumna nie mniejsza niż 'c'.
+        for (int x = 0; x < 3; x++) {
+            while (p[x] < kon[x] && zywe -> k[p[x]] < c - 1) {
+                p[x]++;
+            }
+            for (int q = p[x]; q < kon[x] && zywe -> k[q] <= c + 1; q++) {
+                ile_zywych++;
+                zywa |= (x == 1 && zywe -> k[q] == c);
+            }
+            int q = p[x];
+            if (q < kon[x] && zywe -> k[q] < c) {
+                q++;
+            }
+            if (q < kon[x] && zywe -> k[q] < nastepna) {
+                nastepna = zywe -> k[q];
+            }
+        }
+        if (zywa) {
+            ile_zywych--; // Wtedy policzyliśmy o jedną żywą za dużo.
+        }
+        if (wedlug_reguly(regula, zywa, ile_zywych)) {
+            z -> k[n++] = c;
+        }
+        if (nastepna == INT_MAX) {
+            break;
+        }
+        // Kolejny kandydat to 'c + 1', o ile ma żywego sąsiada.
+        c = nastepna <= c + 2 ? c + 1 : nastepna - 1;
+    }
+    z -> w[z -> ile_w] = r;
+    zakoncz_wiersz(z, n);
+}
+
+/*  Oblicza żywe komórki pasma 'p' w następnej generacji.  */
+WEWNETRZNA void policz_pasmo(Tpasmo* p) {
+    Tzywe* zywe = p -> zywe;
+    Tzywe* z = &(p -> wynik);
+    int i = pierwszy_niemniejszy(zywe -> w, 0, zywe -> ile_w, p -> od_w - 1);
+    int j = pierwszy_niemniejszy(zywe -> w, i, zywe -> ile_w, p -> do_w + 1);
+    // Każda żywa komórka ma kandydatów w trzech wierszach i kolumnach.
+    zarezerwuj(z, 3 * (j - i), 9 * (zywe -> pocz[j] - zywe -> pocz[i]));
+    wyczysc_zywe(z);
+    if (i == j) {
+        return;
+    }
+    int r = zywe -> w[i] - 1 > p -> od_w ? zywe -> w[i] - 1 : p -> od_w;
+    while (r < p -> do_w) {
+        while (i < zywe -> ile_w && zywe -> w[i] < r - 1) {
+            i++;
+        }
+        int rzad[3] = {-1, -1, -1}; // Wiersze 'r - 1', 'r' i 'r + 1'.
+        for (int x = i; x < zywe -> ile_w && zywe -> w[x] <= r + 1; x++) {
+            rzad[zywe -> w[x] - r + 1] = x;
+        }
+        policz_wiersz(zywe, r, rzad[0], rzad[1], rzad[2], z, p -> regula);
+        // Najbliższy żywy wiersz nie mniejszy niż 'r'.
+        int x = rzad[0] >= 0 ? rzad[0] + 1 : i;
+        if (x == zywe -> ile_w) {
+            break;
+        }
+        // Kolejny wiersz to 'r + 1', o ile ma żywego sąsiada.
+        r = zywe -> w[x] <= r + 2 ? r + 1 : zywe -> w[x] - 1;
+    }
+}
+
+/*  Pętla wątku roboczego: czeka na kolejne rundy i liczy w nich swoje 
+    pasmo.  */
+WEWNETRZNA void* pracuj(void* dane) {
+    Trobotnik* r = (Trobotnik*) dane;
+    Tpula* pula = r -> pula;
+    int runda = 0;
+    for (;;) {
+        pthread_mutex_lock(&(pula -> zamek));
+        while (pula -> runda == runda && !pula -> koniec) {
+            pthread_cond_wait(&(pula -> start), &(pula -> zamek));
+        }
+        if (pula -> koniec) {
+            pthread_mutex_unlock(&(pula -> zamek));
+            return NULL;
+        }
+        runda = pula -> runda;
+        pthread_mutex_unlock(&(pula -> zamek));
+        policz_pasmo(&(pula -> pasma[r -> nr]));
+        pthread_mutex_lock(&(pula -> zamek));
+        if (--(pula -> pozostalo) == 0) {
+            pthread_cond_signal(&(pula -> gotowe));
+        }
+        pthread_mutex_unlock(&(pula -> zamek));
+    }
+}
+
+/*  Inicjalizuje pulę 'pula' z 'ile' pasmami i uruchamia 'ile - 1' wątków
+    roboczych.  */
+WEWNETRZNA void inicjalizuj_pule(Tpula* pula, int ile) {
+    pula -> ile = ile;
+    pula -> runda = 0;
+    pula -> pozostalo = 0;
+    pula -> koniec = 0;
+    pula -> pasma = (Tpasmo*) malloc((size_t) ile * sizeof(Tpasmo));
+    pula -> watki = (pthread_t*) malloc((size_t) ile * sizeof(pthread_t));
+    pula -> robotnicy = (Trobotnik*) malloc((size_t) ile * sizeof(Trobotnik));
+    assert(pula -> pasma != NULL && pula -> watki != NULL 
+           && pula -> robotnicy != NULL);
+    for (int i = 0; i < ile; i++) {
+        inicjalizuj_zywe(&(pula -> pasma[i].wynik));
+    }
+    pthread_mutex_init(&(pula -> zamek), NULL);
+    pthread_cond_init(&(pula -> start), NULL);
+    pthread_cond_init(&(pula -> gotowe), NULL);
+    for (int i = 1; i < ile; i++) {
+        pula -> robotnicy[i].pula = pula;
+        pula -> robotnicy[i].nr = i;
+        int blad = pthread_create(&(pula -> watki[i]), NULL, pracuj, 
+                                  &(pula -> robotnicy[i]));
+        assert(blad == 0);
+        (void) blad;
+    }
+}
+
+/*  Kończy wątki puli 'pula' i zwalnia jej pamięć.  */
+WEWNETRZNA void zwolnij_pule(Tpula* pula) {
+    pthread_mutex_lock(&(pula -> zamek));
+    pula -> koniec = 1;
+    pthread_cond_broadcast(&(pula -> start));
+    pthread_mutex_unlock(&(pula -> zamek));
+    for (int i = 1; i < pula -> ile; i++) {
+        pthread_join(pula -> watki[i], NULL);
+    }
+    for (int i = 0; i < pula -> ile; i++) {
+        zwolnij_zywe(&(pula -> pasma[i].wynik));
+    }
+    pthread_mutex_destroy(&(pula -> zamek));
+    pthread_cond_destroy(&(pula -> start));
+    pthread_cond_destroy(&(pula -> gotowe));
+    free(pula -> pasma);
+    free(pula -> watki);
+    free(pula -> robotnicy);
+}
+
+/*  Oblicza następną generację zbioru 'zywe' wątkami puli 'pula' i zapisuje
+    ją w zbiorze 'nast' według reguły 'regula'. Wiersze są dzielone na 
+    pasma o zbliżonej liczbie żywych komórek, a wyniki pasm są sklejane 
+    po kolei.  */
+WEWNETRZNA void krok_pasmami(Tpula* pula, Tzywe* zywe, Tzywe* nast, 
+    int regula) {
+
+    wyczysc_zywe(nast);
+    if (zywe -> ile_w == 0) {
+        return;
+    }
+    long long wszystkie = ile_zywych(zywe);
+    for (int t = 0; t < pula -> ile; t++) {
+        Tpasmo* p = &(pula -> pasma[t]);
+        p -> zywe = zywe;
+        p -> regula = regula;
+        // Pasmo zaczyna się od wiersza, w którym przypada jego część komórek.
+        int i = pierwszy_niemniejszy(zywe -> pocz, 0, zywe -> ile_w, 
+                                     (int) (wszystkie * t / pula -> ile));
+        if (t == 0) {
+            p -> od_w = zywe -> w[0] - 1;
+        }
+        else {
+            p -> od_w = i < zywe -> ile_w ? zywe -> w[i] 
+                        : zywe -> w[zywe -> ile_w - 1] + 2;
+        }
+        if (t > 0) {
+            pula -> pasma[t - 1].do_w = p -> od_w;
+        }
+    }
+    pula -> pasma[pula -> ile - 1].do_w = zywe -> w[zywe -> ile_w - 1] + 2;
+    pthread_mutex_lock(&(pula -> zamek));
+    pula -> pozostalo = pula -> ile - 1;
+    pula -> runda++;
+    pthread_cond_broadcast(&(pula -> start));
+    pthread_mutex_unlock(&(pula -> zamek));
+    policz_pasmo(&(pula -> pasma[0]));
+    pthread_mutex_lock(&(pula -> zamek));
+    while (pula -> pozostalo > 0) {
+        pthread_cond_wait(&(pula -> gotowe), &(pula -> zamek));
+    }
+    pthread_mutex_unlock(&(pula -> zamek));
+    // Sklejanie pasm.
+    int wiersze = 0, kolumny = 0;
+    for (int t = 0; t < pula -> ile; t++) {
+        wiersze += pula -> pasma[t].wynik.ile_w;
+        kolumny += ile_zywych(&(pula -> pasma[t].wynik));
+    }
+    zarezerwuj(nast, wiersze, kolumny);
+    for (int t = 0; t < pula -> ile; t++) {
+        dopisz_zywe(nast, &(pula -> pasma[t].wynik));
+    }
+}
+
+/*  Wysyła przez gniazdo 'g' 'ile' bajtów z 'dane'. Przekazuje 1, jeśli 
+    się to udało, a 0, jeśli drugi koniec gniazda został zamknięty.  */
+WEWNETRZNA int wyslij(int g, const void* dane, size_t ile) {
+    const char* p = (const char*) dane;
+    while (ile > 0) {
+        ssize_t r = send(g, p, ile, MSG_NOSIGNAL);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            return 0;
+        }
+        p += r;
+        ile -= (size_t) r;
+    }
+    return 1;
+}
+
+/*  Odbiera z gniazda 'g' 'ile' bajtów do 'dane'. Przekazuje 1, jeśli się
+    to udało, a 0, jeśli drugi koniec gniazda został zamknięty.  */
+WEWNETRZNA int odbierz(int g, void* dane, size_t ile) {
+    char* p = (char*) dane;
+    while (ile > 0) {
+        ssize_t r = recv(g, p, ile, 0);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            return 0;
+        }
+        p += r;
+        ile -= (size_t) r;
+    }
+    return 1;
+}
+
+/*  Wysyła przez gniazdo 'g' wiersze zbioru 'z' od 'i' do 'j' (bez niego):
+    liczbę wierszy i komórek, numery wierszy, początki wierszy i kolumny.
+    Przekazuje 1, jeśli się to udało, a w przeciwnym przypadku 0.  */
+WEWNETRZNA int wyslij_wiersze(int g, Tzywe* z, int i, int j) {
+    int naglowek[2] = {j - i, z -> pocz[j] - z -> pocz[i]};
+    return wyslij(g, naglowek, sizeof(naglowek))
+           && wyslij(g, z -> w + i, (size_t) naglowek[0] * sizeof(int))
+           && wyslij(g, z -> pocz + i, 
+                     (size_t) (naglowek[0] + 1) * sizeof(int))
+           && wyslij(g, z -> k + z -> pocz[i], 
+                     (size_t) naglowek[1] * sizeof(int));
+}
+
+/*  Dopisuje na koniec zbioru 'z' wiersze odebrane z gniazda 'g', które
+    muszą leżeć za ostatnim wierszem 'z'. Przekazuje 1, jeśli się to 
+    udało, a w przeciwnym przypadku 0.  */
+WEWNETRZNA int odbierz_wiersze(int g, Tzywe* z) {
+    int naglowek[2];
+    if (!odbierz(g, naglowek, sizeof(naglowek))) {
+        return 0;
+    }
+    int n = ile_zywych(z);
+    zarezerwuj(z, z -> ile_w + naglowek[0], n + naglowek[1]);
+    int* pocz = z -> pocz + z -> ile_w;
+    if (!odbierz(g, z -> w + z -> ile_w, (size_t) naglowek[0] * sizeof(int))
+        || !odbierz(g, pocz, (size_t) (naglowek[0] + 1) * sizeof(int))
+        || !odbierz(g, z -> k + n, (size_t) naglowek[1] * sizeof(int))) {
+        return 0;
+    }
+    // Początki wierszy liczone są od początku przesłanego fragmentu.
+    int przes = n - pocz[0];
+    for (int i = 0; i <= naglowek[0]; i++) {
+        pocz[i] += przes;
+    }
+    z -> ile_w += naglowek[0];
+    return 1;
+}
+
+/*  Zapisuje w '*s' stan pasa o żywych komórkach 'pas' i granicach 'od_w'
+    i 'do_w'.  */
+WEWNETRZNA void zapisz_stan_pasa(Tzywe* pas, int od_w, int do_w, 
+    Tstan_pasa* s) {
+
+    memset(s, 0, sizeof(*s));
+    s -> od_w = od_w;
+    s -> do_w = do_w;
+    s -> wiersze = pas -> ile_w;
+    s -> zywe = ile_zywych(pas);
+    if (pas -> ile_w > 0) {
+        s -> pierwszy_w = pas -> w[0];
+        s -> ostatni_w = pas -> w[pas -> ile_w - 1];
+        s -> lewa_k = INT_MAX;
+        s -> prawa_k = INT_MIN;
+        for (int i = 0; i < pas -> ile_w; i++) {
+            int lewa = pas -> k[pas -> pocz[i]];
+            int prawa = pas -> k[pas -> pocz[i + 1] - 1];
+            s -> lewa_k = lewa < s -> lewa_k ? lewa : s -> lewa_k;
+            s -> prawa_k = prawa > s -> prawa_k ? prawa : s -> prawa_k;
+        }
+    }
+}
+
+/*  Dopisuje na koniec zbioru 'wynik' żywe komórki zbioru 'z' leżące 
+    w prostokącie 'r'.  */
+WEWNETRZNA void wytnij_prostokat(Tzywe* z, Tprostokat r, Tzywe* wynik) {
+    for (int i = pierwszy_niemniejszy(z -> w, 0, z -> ile_w, r.w1); 
+         i < z -> ile_w && z -> w[i] <= r.w2; i++) {
+        int j = pierwszy_niemniejszy(z -> k, z -> pocz[i], z -> pocz[i + 1], 
+                                     r.k1);
+        int koniec = r.k2 == INT_MAX ? z -> pocz[i + 1] 
+            : pierwszy_niemniejszy(z -> k, j, z -> pocz[i + 1], r.k2 + 1);
+        if (koniec > j) {
+            int n = ile_zywych(wynik);
+            zarezerwuj(wynik, wynik -> ile_w + 1, n + koniec - j);
+            memcpy(wynik -> k + n, z -> k + j, 
+                   (size_t) (koniec - j) * sizeof(int));
+            wynik -> w[wynik -> ile_w] = z -> w[i];
+            zakoncz_wiersz(wynik, n + koniec - j);
+        }
+    }
+}
+
+/*  Wysyła procesom liczącym pasy powyżej i poniżej (gniazda 'gora' i 'dol'
+    albo -1, jeśli ich nie ma) skrajne wiersze pasa 'pas' pasma 'p', 
+    o ile leżą tuż przy granicy. Przekazuje 1, jeśli się to udało, 
+    a 0, jeśli zerwało się połączenie.  */
+WEWNETRZNA int wyslij_brzegi(Tzywe* pas, Tpasmo* p, int gora, int dol) {
+    int ok = 1;
+    if (gora >= 0) {
+        int gorne = pas -> ile_w > 0 && pas -> w[0] == p -> od_w;
+        ok = wyslij_wiersze(gora, pas, 0, gorne);
+    }
+    if (ok && dol >= 0) {
+        int dolne = pas -> ile_w > 0 
+                    && pas -> w[pas -> ile_w - 1] == p -> do_w - 1;
+        ok = wyslij_wiersze(dol, pas, pas -> ile_w - dolne, pas -> ile_w);
+    }
+    return ok;
+}
+
+/*  Oblicza 'ile' kolejnych generacji pasa 'pas' wierszy od 'p -> od_w' do
+    'p -> do_w' (bez niego). 'gora' i 'dol' to gniazda łączące z procesami
+    liczącymi pasy powyżej i poniżej albo -1, jeśli ich nie ma. Przed każdą
+    generacją proces wysyła sąsiadom swój skrajny wiersz i dostaje od nich
+    wiersz leżący tuż za pasem, czyli wszystko, czego potrzeba do 
+    policzenia pasa. Wymiana ma dwie tury niezależnie od liczby procesów:
+    procesy o parzystym numerze 'nr' najpierw nadają, a nieparzyste 
+    odbierają, a potem na odwrót. Sąsiedzi mają różną parzystość, więc 
+    wymiana nie może się zablokować. Przekazuje 1, jeśli się to udało, 
+    a 0, jeśli zerwało się połączenie.  */
+WEWNETRZNA int generacje_pasa(Tzywe* pas, Tpasmo* p, long long ile, int nr, 
+    int gora, int dol) {
+
+    Tzywe* obok = p -> zywe; // Żywe komórki pasa i wierszy tuż za nim.
+    int ok = 1;
+    for (long long i = 0; ok && i < ile; i++) {
+        wyczysc_zywe(obok);
+        if (nr % 2 == 0) {
+            ok = wyslij_brzegi(pas, p, gora, dol);
+        }
+        ok = ok && (gora < 0 || odbierz_wiersze(gora, obok));
+        dopisz_zywe(obok, pas);
+        ok = ok && (dol < 0 || odbierz_wiersze(dol, obok));
+        if (nr % 2 == 1) {
+            ok = ok && wyslij_brzegi(pas, p, gora, dol);
+        }
+        policz_pasmo(p);
+        Tzywe temp = *pas;
+        *pas = p -> wynik;
+        p -> wynik = temp;
+    }
+    return ok;
+}
+
+/*  Przesuwa granicę pasa 'pas' z pasem sąsiada połączonego gniazdem 'g':
+    dolną, jeśli 'dolna' jest niezerowe, a w przeciwnym przypadku górną.
+    Granice pasa leżą w '*od_w' i '*do_w'. Proces oddaje sąsiadowi skrajne
+    wiersze, które mają razem co najmniej 'oddaj' komórek, ale zawsze 
+    zostawia sobie wiersz przy drugiej granicy, i dostaje od sąsiada 
+    wiersze, które ten mu oddaje (z dwóch sąsiadów oddaje co najwyżej 
+    jeden). Górny proces nadaje pierwszy. 'obok' i 'nowy' to zbiory 
+    pomocnicze. Przekazuje 1, jeśli się to udało, a 0, jeśli zerwało się
+    połączenie.  */
+WEWNETRZNA int przesun_granice(int g, int dolna, long long oddaj, Tzywe* pas, 
+    Tzywe* obok, Tzywe* nowy, int* od_w, int* do_w) {
+
+    int i = 0, j = pas -> ile_w; // Zostają wiersze od 'i' do 'j'.
+    long long oddane = 0;
+    while (dolna && oddane < oddaj && j > 0 && pas -> w[j - 1] > *od_w) {
+        j--;
+        oddane += pas -> pocz[j + 1] - pas -> pocz[j];
+    }
+    while (!dolna && oddane < oddaj && i < j && pas -> w[i] < *do_w - 1) {
+        oddane += pas -> pocz[i + 1] - pas -> pocz[i];
+        i++;
+    }
+    wyczysc_zywe(obok);
+    int ok = dolna 
+        ? wyslij_wiersze(g, pas, j, pas -> ile_w) && odbierz_wiersze(g, obok)
+        : odbierz_wiersze(g, obok) && wyslij_wiersze(g, pas, 0, i);
+    if (!ok) {
+        return 0;
+    }
+    wyczysc_zywe(nowy);
+    if (dolna) {
+        if (j < pas -> ile_w) {
+            *do_w = pas -> w[j];
+        }
+        else if (obok -> ile_w > 0) {
+            *do_w = obok -> w[obok -> ile_w - 1] + 1;
+        }
+        dopisz_wiersze(nowy, pas, 0, j);
+        dopisz_zywe(nowy, obok);
+    }
+    else {
+        if (i > 0) {
+            *od_w = pas -> w[i - 1] + 1;
+        }
+        else if (obok -> ile_w > 0) {
+            *od_w = obok -> w[0];
+        }
+        dopisz_zywe(nowy, obok);
+        dopisz_wiersze(nowy, pas, i, pas -> ile_w);
+    }
+    Tzywe temp = *pas;
+    *pas = *nowy;
+    *nowy = temp;
+    return 1;
+}
+
+/*  Pętla procesu roboczego: wykonuje zlecenia odbierane z gniazda 'g'. 
+    Pas zostaje w procesie między zleceniami, a do procesu głównego 
+    trafia tylko jego stan albo komórki z zadanego prostokąta. 'nr' to 
+    numer procesu, a 'gora' i 'dol' to gniazda łączące z procesami 
+    liczącymi pasy powyżej i poniżej albo -1, jeśli ich nie ma. 
+    Przekazuje 1, jeśli proces zakończył się na zlecenie, a 0, jeśli 
+    zerwało się połączenie.  */
+WEWNETRZNA int pracuj_w_procesie(int g, int nr, int gora, int dol) {
+    Tzywe pas; // Żywe komórki pasa.
+    Tzywe obok; // Żywe komórki pasa i wierszy tuż za nim.
+    Tpasmo p;
+    inicjalizuj_zywe(&pas);
+    inicjalizuj_zywe(&obok);
+    inicjalizuj_zywe(&(p.wynik));
+    p.zywe = &obok;
+    p.od_w = INT_MIN + 1;
+    p.do_w = INT_MAX - 1;
+    p.regula = 0;
+    Tzlecenie z;
+    int ok = odbierz(g, &z, sizeof(z));
+    while (ok && z.rodzaj != ZLECENIE_KONIEC) {
+        switch (z.rodzaj) {
+            case ZLECENIE_PAS:
+                p.od_w = z.od_w;
+                p.do_w = z.do_w;
+                p.regula = z.regula;
+                wyczysc_zywe(&pas);
+                ok = odbierz_wiersze(g, &pas);
+                break;
+            case ZLECENIE_GENERACJE:
+                ok = generacje_pasa(&pas, &p, z.ile, nr, gora, dol);
+                break;
+            case ZLECENIE_WYROWNAJ:
+                // Między zleceniami 'p.wynik' jest wolny.
+                if (gora >= 0) {
+                    ok = przesun_granice(gora, 0, z.w_gore, &pas, &obok, 
+                        &(p.wynik), &(p.od_w), &(p.do_w));
+                }
+                if (ok && dol >= 0) {
+                    ok = przesun_granice(dol, 1, z.w_dol, &pas, &obok, 
+                        &(p.wynik), &(p.od_w), &(p.do_w));
+                }
+                break;
+            case ZLECENIE_PROSTOKAT:
+                wyczysc_zywe(&obok);
+                wytnij_prostokat(&pas, z.r, &obok);
+                ok = wyslij_wiersze(g, &obok, 0, obok.ile_w);
+                break;
+            default: assert(0); // Błąd.
+        }
+        if (ok && z.rodzaj != ZLECENIE_PROSTOKAT) {
+            Tstan_pasa s;
+            zapisz_stan_pasa(&pas, p.od_w, p.do_w, &s);
+            ok = wyslij(g, &s, sizeof(s));
+        }
+        ok = ok && odbierz(g, &z, sizeof(z));
+    }
+    zwolnij_zywe(&pas);
+    zwolnij_zywe(&obok);
+    zwolnij_zywe(&(p.wynik));
+    return ok;
+}
+
+/*  Przekazuje zlecenie rodzaju 'rodzaj' z wyzerowanymi pozostałymi 
+    polami.  */
+WEWNETRZNA Tzlecenie nowe_zlecenie(int rodzaj) {
+    Tzlecenie z;
+    memset(&z, 0, sizeof(z));
+    z.rodzaj = rodzaj;
+    return z;
+}
+
+/*  Uruchamia 'ile' procesów roboczych 'r' i łączy je gniazdami: każdy 
+    z procesem głównym i z procesami o sąsiednich numerach.  */
+WEWNETRZNA void uruchom_procesy(Tprocesy* r, int ile) {
+    r -> ile = ile;
+    r -> pid = (pid_t*) malloc((size_t) ile * sizeof(pid_t));
+    r -> gniazda = (int*) malloc((size_t) ile * sizeof(int));
+    r -> pasy = (Tstan_pasa*) malloc((size_t) ile * sizeof(Tstan_pasa));
+    // Końce gniazd należące do procesów: do procesu głównego, do procesu 
+    // powyżej i do procesu poniżej.
+    int* konce = (int*) malloc((size_t) 3 * (size_t) ile * sizeof(int));
+    assert(r -> pid != NULL && r -> gniazda != NULL && r -> pasy != NULL
+           && konce != NULL);
+    for (int t = 0; t < ile; t++) {
+        int para[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, para) != 0) {
+            fprintf(stderr, "Nie można utworzyć gniazd procesów\n");
+            exit(1);
+        }
+        r -> gniazda[t] = para[0];
+        konce[3 * t] = para[1];
+        konce[3 * t + 1] = -1;
+        konce[3 * t + 2] = -1;
+        if (t > 0) {
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, para) != 0) {
+                fprintf(stderr, "Nie można utworzyć gniazd procesów\n");
+                exit(1);
+            }
+            konce[3 * (t - 1) + 2] = para[0];
+            konce[3 * t + 1] = para[1];
+        }
+    }
+    fflush(stdout);
+    for (int t = 0; t < ile; t++) {
+        r -> pid[t] = fork();
+        if (r -> pid[t] < 0) {
+            fprintf(stderr, "Nie można uruchomić procesów roboczych\n");
+            exit(1);
+        }
+        if (r -> pid[t] == 0) {
+            // Proces roboczy zamyka gniazda, które nie są jego.
+            for (int i = 0; i < ile; i++) {
+                close(r -> gniazda[i]);
+                for (int j = 0; j < 3 && i != t; j++) {
+                    if (konce[3 * i + j] >= 0) {
+                        close(konce[3 * i + j]);
+                    }
+                }
+            }
+            _exit(pracuj_w_procesie(konce[3 * t], t, konce[3 * t + 1], 
+                                    konce[3 * t + 2]) ? 0 : 1);
+        }
+    }
+    for (int i = 0; i < 3 * ile; i++) {
+        if (konce[i] >= 0) {
+            close(konce[i]);
+        }
+    }
+    free(konce);
+}
+
+/*  Kończy procesy robocze 'r' i zwalnia pamięć.  */
+WEWNETRZNA void zatrzymaj_procesy(Tprocesy* r) {
+    Tzlecenie z = nowe_zlecenie(ZLECENIE_KONIEC);
+    for (int t = 0; t < r -> ile; t++) {
+        wyslij(r -> gniazda[t], &z, sizeof(z));
+        close(r -> gniazda[t]);
+    }
+    for (int t = 0; t < r -> ile; t++) {
+        waitpid(r -> pid[t], NULL, 0);
+    }
+    free(r -> pid);
+    free(r -> gniazda);
+    free(r -> pasy);
+}
+
+/*  Wysyła zlecenie 'z' procesowi roboczemu 'p' spośród 'r'. Kończy 
+    program, jeśli proces nie odpowiada.  */
+WEWNETRZNA void zlec(Tprocesy* r, int p, Tzlecenie* z) {
+    if (!wyslij(r -> gniazda[p], z, sizeof(*z))) {
+        fprintf(stderr, "Proces roboczy nie odpowiada\n");
+        exit(1);
+    }
+}
+
+/*  Odbiera stan pasa procesu roboczego 'p' spośród 'r'. Kończy program, 
+    jeśli proces nie odpowiada.  */
+WEWNETRZNA void odbierz_stan(Tprocesy* r, int p) {
+    if (!odbierz(r -> gniazda[p], &(r -> pasy[p]), sizeof(Tstan_pasa))) {
+        fprintf(stderr, "Proces roboczy nie odpowiada\n");
+        exit(1);
+    }
+}
+
+/*  Dopisuje na koniec zbioru 'z' żywe komórki pasa procesu roboczego 'p' 
+    spośród 'r' leżące w prostokącie 'pr'. Kończy program, jeśli proces 
+    nie odpowiada.  */
+WEWNETRZNA void pobierz_pas(Tprocesy* r, int p, Tprostokat pr, Tzywe* z) {
+    Tzlecenie zl = nowe_zlecenie(ZLECENIE_PROSTOKAT);
+    zl.r = pr;
+    zlec(r, p, &zl);
+    if (!odbierz_wiersze(r -> gniazda[p], z)) {
+        fprintf(stderr, "Proces roboczy nie odpowiada\n");
+        exit(1);
+    }
+}
+
+/*  Przekazuje liczbę żywych komórek w pasach procesów roboczych 'r'.  */
+WEWNETRZNA long long zywe_procesow(Tprocesy* r) {
+    long long ile = 0;
+    for (int p = 0; p < r -> ile; p++) {
+        ile += r -> pasy[p].zywe;
+    }
+    return ile;
+}
+
+/*  Zapisuje w zbiorze 'z' wszystkie żywe komórki pasów procesów roboczych
+    'r', pobierane po kolei od każdego procesu.  */
+WEWNETRZNA void zbierz_pasy(Tprocesy* r, Tzywe* z) {
+    Tprostokat calosc = {INT_MIN, INT_MIN, INT_MAX, INT_MAX};
+    wyczysc_zywe(z);
+    for (int p = 0; p < r -> ile; p++) {
+        pobierz_pas(r, p, calosc, z);
+    }
+}
+
+/*  Przesuwa granice pasów procesów roboczych 'r' tak, aby pasy miały 
+    mniej więcej tyle samo komórek. Komórki nie przechodzą przez proces
+    główny: każda granica przesuwa się o skrajne wiersze jednego z dwóch
+    sąsiednich pasów, więc pas może w jednym wyrównaniu dostać tylko to, 
+    co mają jego sąsiedzi. Pasy zostają bez zmian, dopóki największy nie 
+    ma o ponad ćwierć komórek więcej niż średnio.  */
+WEWNETRZNA void wyrownaj_pasy(Tprocesy* r) {
+    long long wszystkie = zywe_procesow(r);
+    long long najwiecej = 0;
+    for (int p = 0; p < r -> ile; p++) {
+        if (r -> pasy[p].zywe > najwiecej) {
+            najwiecej = r -> pasy[p].zywe;
+        }
+    }
+    if (4 * najwiecej * r -> ile <= 5 * wszystkie) {
+        return;
+    }
+    long long przed = 0; // Liczba komórek w pasach powyżej pasa 'p'.
+    for (int p = 0; p < r -> ile; p++) {
+        // Tyle komórek powinno leżeć powyżej pasa i powyżej następnego.
+        long long cel = wszystkie * p / r -> ile;
+        long long cel_dalej = wszystkie * (p + 1) / r -> ile;
+        Tzlecenie z = nowe_zlecenie(ZLECENIE_WYROWNAJ);
+        z.w_gore = cel > przed ? cel - przed : 0;
+        przed += r -> pasy[p].zywe;
+        z.w_dol = p < r -> ile - 1 && przed > cel_dalej ? przed - cel_dalej : 0;
+        zlec(r, p, &z);
+    }
+    for (int p = 0; p < r -> ile; p++) {
+        odbierz_stan(r, p);
+    }
+}
+
+/*  Przekazuje liczbę zapalonych bitów w słowie 'x'.  */
+WEWNETRZNA int ile_bitow(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    int ile = 0;
+    for (; x != 0; x &= x - 1) {
+        ile++;
+    }
+    return ile;
+#endif
+}
+
+/*  Przekazuje numer najmłodszego zapalonego bitu niezerowego słowa 'x'.  */
+WEWNETRZNA int najnizszy_bit(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int b = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        b++;
+    }
+    return b;
+#endif
+}
+
+/*  Inicjalizuje pustą planszę bitową 'p'.  */
+WEWNETRZNA void inicjalizuj_bity(Tbity* p) {
+    p -> wiersze = 0;
+    p -> slowa = 0;
+    p -> min_w = 0;
+    p -> min_k = 0;
+    p -> akt = NULL;
+    p -> nast = NULL;
+    p -> wysokosc = 0;
+    p -> szerokosc = 0;
+    p -> torus = 0;
+    p -> do_przegladu = PRZEGLAD_BITOW;
+}
+
+/*  Zwalnia pamięć zarezerwowaną przez planszę bitową 'p'.  */
+WEWNETRZNA void zwolnij_bity(Tbity* p) {
+    free(p -> akt);
+    free(p -> nast);
+    inicjalizuj_bity(p);
+}
+
+/*  Przydziela pustej planszy bitowej 'p' raz na zawsze tablice na 
+    'wysokosc' wierszy i 'szerokosc' kolumn wraz z pasem wokół nich. 
+    Komórki wychodzące poza brzeg giną albo, gdy 'torus' jest niezerowe, 
+    wracają z przeciwnej strony.  */
+WEWNETRZNA void ustal_bity(Tbity* p, int wysokosc, int szerokosc, int torus) {
+    p -> wysokosc = wysokosc;
+    p -> szerokosc = szerokosc;
+    p -> torus = torus;
+    p -> min_w = -1;
+    p -> min_k = -64;
+    p -> wiersze = wysokosc + 2;
+    int slowa = (szerokosc + 63) / 64;
+    p -> slowa = (slowa + SZEROKOSC_WEKTORA - 1) / SZEROKOSC_WEKTORA
+                 * SZEROKOSC_WEKTORA + 2;
+    size_t rozmiar = (size_t) p -> wiersze * (size_t) p -> slowa;
+    p -> akt = (uint64_t*) calloc(rozmiar, sizeof(uint64_t));
+    p -> nast = (uint64_t*) calloc(rozmiar, sizeof(uint64_t));
+    assert(p -> akt != NULL && p -> nast != NULL);
+}
+
+/*  Przekazuje wskaźnik na wiersz 'r' (liczony od zera) tablicy 'tab' 
+    planszy bitowej 'p'.  */
+WEWNETRZNA uint64_t* wiersz_bitow(Tbity* p, uint64_t* tab, int r) {
+    return tab + (size_t) r * (size_t) p -> slowa;
+}
+
+/*  Przydziela planszy 'p' wyzerowane tablice, w których mieszczą się 
+    wiersze od 'gora_w' do 'dol_w' i kolumny od 'lewa_k' do 'prawa_k' 
+    wraz z marginesami. Przekazuje nową tablicę bieżącej generacji, a stare
+    tablice zostawia do zwolnienia wywołującemu.  */
+WEWNETRZNA uint64_t* rozmiesc_bity(
+    Tbity* p, int gora_w, int dol_w, int lewa_k, int prawa_k) {
+
+    // Pas martwych komórek nad i pod wzorem oraz po bokach.
+    p -> min_w = gora_w - MARGINES_BITOW - 1;
+    p -> wiersze = dol_w - gora_w + 1 + 2 * (MARGINES_BITOW + 1);
+    // Słowo nr 0 i ostatnie są zawsze puste, a liczba słów pomiędzy nimi
+    // jest wielokrotnością szerokości wektora.
+    p -> min_k = lewa_k - 64 * (MARGINES_BITOW / 64 + 2);
+    int slowa = (prawa_k - p -> min_k + MARGINES_BITOW) / 64 + 1;
+    slowa = (slowa + SZEROKOSC_WEKTORA - 1) / SZEROKOSC_WEKTORA
+            * SZEROKOSC_WEKTORA;
+    p -> slowa = slowa + 2;
+    size_t rozmiar = (size_t) p -> wiersze * (size_t) p -> slowa;
+    p -> nast = (uint64_t*) calloc(rozmiar, sizeof(uint64_t));
+    uint64_t* akt = (uint64_t*) calloc(rozmiar, sizeof(uint64_t));
+    assert(p -> nast != NULL && akt != NULL);
+    return akt;
+}
+
+/*  Przenosi żywe komórki ze zbioru 'zywe' na planszę bitową 'p' 
+    o stałych wymiarach. Komórki spoza planszy są zawijane na torus albo 
+    pomijane.  */
+WEWNETRZNA void zaladuj_staly_bity(Tbity* p, Tzywe* zywe) {
+    memset(p -> akt, 0, (size_t) p -> wiersze * (size_t) p -> slowa 
+                        * sizeof(uint64_t));
+    for (int i = 0; i < zywe -> ile_w; i++) {
+        long long w = zywe -> w[i];
+        if (p -> torus) {
+            w = (w % p -> wysokosc + p -> wysokosc) % p -> wysokosc;
+        }
+        else if (w < 0 || w >= p -> wysokosc) {
+            continue;
+        }
+        uint64_t* wiersz = wiersz_bitow(p, p -> akt, (int) w + 1);
+        for (int j = zywe -> pocz[i]; j < zywe -> pocz[i + 1]; j++) {
+            long long k = zywe -> k[j];
+            if (p -> torus) {
+                k = (k % p -> szerokosc + p -> szerokosc) % p -> szerokosc;
+            }
+            else if (k < 0 || k >= p -> szerokosc) {
+                continue;
+            }
+            wiersz[k / 64 + 1] |= (uint64_t) 1 << (k % 64);
+        }
+    }
+}
+
+/*  Przenosi żywe komórki ze zbioru 'zywe' na planszę bitową 'p'.  */
+WEWNETRZNA void zaladuj_bity(Tbity* p, Tzywe* zywe) {
+    if (p -> wysokosc > 0) {
+        zaladuj_staly_bity(p, zywe);
+        return;
+    }
+    zwolnij_bity(p);
+    if (zywe -> ile_w == 0) {
+        p -> akt = rozmiesc_bity(p, 0, 0, 0, 0);
+        return;
+    }
+    int lewa_k = INT_MAX;
+    int prawa_k = INT_MIN;
+    for (int i = 0; i < zywe -> ile_w; i++) {
+        if (zywe -> k[zywe -> pocz[i]] < lewa_k) {
+            lewa_k = zywe -> k[zywe -> pocz[i]];
+        }
+        if (zywe -> k[zywe -> pocz[i + 1] - 1] > prawa_k) {
+            prawa_k = zywe -> k[zywe -> pocz[i + 1] - 1];
+        }
+    }
+    p -> akt = rozmiesc_bity(
+        p, zywe -> w[0], zywe -> w[zywe -> ile_w - 1], lewa_k, prawa_k);
+    for (int i = 0; i < zywe -> ile_w; i++) {
+        uint64_t* wiersz = wiersz_bitow(p, p -> akt, zywe -> w[i] - p -> min_w);
+        for (int j = zywe -> pocz[i]; j < zywe -> pocz[i + 1]; j++) {
+            int x = zywe -> k[j] - p -> min_k;
+            wiersz[x / 64] |= (uint64_t) 1 << (x % 64);
+        }
+    }
+}
+
+/*  Zapisuje żywe komórki z planszy bitowej 'p' do zbioru 'zywe'.  */
+WEWNETRZNA void zapisz_bity(Tbity* p, Tzywe* zywe) {
+    wyczysc_zywe(zywe);
+    int n = 0;
+    for (int r = 1; r < p -> wiersze - 1; r++) {
+        uint64_t* wiersz = wiersz_bitow(p, p -> akt, r);
+        int ile = 0;
+        for (int s = 1; s < p -> slowa - 1; s++) {
+            ile += ile_bitow(wiersz[s]);
+        }
+        if (ile == 0) {
+            continue;
+        }
+        zarezerwuj(zywe, zywe -> ile_w + 1, n + ile);
+        zywe -> w[zywe -> ile_w] = p -> min_w + r;
+        for (int s = 1; s < p -> slowa - 1; s++) {
+            for (uint64_t x = wiersz[s]; x != 0; x &= x - 1) {
+                zywe -> k[n++] = p -> min_k + 64 * s + najnizszy_bit(x);
+            }
+        }
+        zakoncz_wiersz(zywe, n);
+    }
+}
+
+/*  Sprawdza, czy żywe komórki planszy 'p' dotykają skrajnych liczonych
+    wierszy lub słów, czyli czy przed kolejnym krokiem trzeba przesunąć
+    je dalej od brzegów.  */
+WEWNETRZNA int bity_przy_brzegu(Tbity* p) {
+    uint64_t suma = 0;
+    uint64_t* gora = wiersz_bitow(p, p -> akt, 1);
+    uint64_t* dol = wiersz_bitow(p, p -> akt, p -> wiersze - 2);
+    for (int s = 1; s < p -> slowa - 1; s++) {
+        suma |= gora[s] | dol[s];
+    }
+    for (int r = 1; r < p -> wiersze - 1; r++) {
+        uint64_t* wiersz = wiersz_bitow(p, p -> akt, r);
+        suma |= wiersz[1] | wiersz[p -> slowa - 2];
+    }
+    return suma != 0;
+}
+
+/*  Zapisuje w '*gora' i '*dol' skrajne niepuste wiersze, a w '*lewe'
+    i '*prawe' skrajne niepuste słowa liczonej części planszy 'p'. Na pustej
+    planszy '*gora' to INT_MAX.  */
+WEWNETRZNA void granice_bitow(Tbity* p, int* gora, int* dol, int* lewe, 
+    int* prawe) {
+
+    *gora = INT_MAX;
+    *dol = INT_MIN;
+    *lewe = INT_MAX;
+    *prawe = INT_MIN;
+    for (int r = 1; r < p -> wiersze - 1; r++) {
+        uint64_t* wiersz = wiersz_bitow(p, p -> akt, r);
+        for (int s = 1; s < p -> slowa - 1; s++) {
+            if (wiersz[s] != 0) {
+                *gora = r < *gora ? r : *gora;
+                *dol = r;
+                *lewe = s < *lewe ? s : *lewe;
+                *prawe = s > *prawe ? s : *prawe;
+            }
+        }
+    }
+}
+
+/*  Co 'PRZEGLAD_BITOW' wywołań sprawdza, czy plansza 'p' jest ponad 
+    'LUZ_BITOW' razy większa od prostokąta ograniczającego jej żywe 
+    komórki wraz z marginesami, np. po wymarciu większości zupy. Plansza
+    rośnie tylko wtedy, gdy komórki dotkną brzegu, więc bez tego zostałaby
+    duża do końca, a każdy krok liczyłby ją całą.  */
+WEWNETRZNA int bity_za_duze(Tbity* p) {
+    p -> do_przegladu--;
+    if (p -> do_przegladu > 0) {
+        return 0;
+    }
+    p -> do_przegladu = PRZEGLAD_BITOW;
+    int gora, dol, lewe, prawe;
+    granice_bitow(p, &gora, &dol, &lewe, &prawe);
+    if (gora == INT_MAX) {
+        gora = dol = lewe = prawe = 0;
+    }
+    long long potrzebne = 
+        ((long long) dol - gora + 1 + 2 * (MARGINES_BITOW + 1))
+        * ((long long) prawe - lewe + 1 + 2 * (MARGINES_BITOW / 64 + 2) 
+           + SZEROKOSC_WEKTORA);
+    return (long long) p -> wiersze * p -> slowa > LUZ_BITOW * potrzebne;
+}
+
+/*  Rozmieszcza żywe komórki planszy 'p' na nowo, tak aby wokół nich znów
+    był pełny margines. Przy okazji plansza kurczy się do prostokąta
+    ograniczającego żywe komórki.  */
+WEWNETRZNA void przesun_bity(Tbity* p) {
+    int gora, dol; // Skrajne niepuste wiersze.
+    int lewe, prawe; // Skrajne niepuste słowa.
+    granice_bitow(p, &gora, &dol, &lewe, &prawe);
+    Tbity stara = *p;
+    if (gora == INT_MAX) {
+        p -> akt = rozmiesc_bity(p, 0, 0, 0, 0);
+    }
+    else {
+        // Nowe położenie jest przesunięte o całe słowa, więc wiersze można
+        // kopiować bez przesuwania bitów.
+        p -> akt = rozmiesc_bity(p, stara.min_w + gora, stara.min_w + dol,
+            stara.min_k + 64 * lewe, stara.min_k + 64 * prawe + 63);
+        int przes = (stara.min_k - p -> min_k) / 64;
+        for (int r = gora; r <= dol; r++) {
+            memcpy(wiersz_bitow(p, p -> akt, r + stara.min_w - p -> min_w)
+                       + lewe + przes,
+                wiersz_bitow(&stara, stara.akt, r) + lewe,
+                (size_t) (prawe - lewe + 1) * sizeof(uint64_t));
+        }
+    }
+    free(stara.akt);
+    free(stara.nast);
+}
+
+/*  Zapisuje w 'wynik' następną generację bitów 'o[1][1]' według reguły
+    'regula', mając ich otoczenie 'o': wiersz 'o[0]' leży wyżej, 'o[2]' 
+    niżej, a 'o[.][0]' i 'o[.][2]' to sąsiedzi z lewej i prawej. Osiem 
+    sąsiadów każdej komórki jest sumowanych równolegle dla wszystkich bitów
+    za pomocą sumatorów. Gdy reguła jest stałą, zostaje z niej tylko 
+    wyrażenie dla tych liczb sąsiadów, które ona wymienia.  */
+WPLATANA void nowe_bity(Twektor o[3][3], Twektor* wynik, int regula) {
+    Twektor gl = o[0][0], g = o[0][1], gp = o[0][2];
+    Twektor xl = o[1][0], x = o[1][1], xp = o[1][2];
+    Twektor dl = o[2][0], d = o[2][1], dp = o[2][2];
+    // Sumy w rzędzie górnym, środkowym i dolnym (bity jedności i dwójek).
+    Twektor g0 = gl ^ g ^ gp;
+    Twektor g1 = (gl & g) | (gp & (gl ^ g));
+    Twektor x0 = xl ^ xp;
+    Twektor x1 = xl & xp;
+    Twektor d0 = dl ^ d ^ dp;
+    Twektor d1 = (dl & d) | (dp & (dl ^ d));
+    // Suma całkowita s0 + 2 * s1 + 4 * s2 + 8 * s3.
+    Twektor s0 = g0 ^ x0 ^ d0;
+    Twektor c0 = (g0 & x0) | (d0 & (g0 ^ x0));
+    Twektor p = g1 ^ x1;
+    Twektor q = d1 ^ c0;
+    Twektor s1 = p ^ q;
+    Twektor c1 = g1 & x1;
+    Twektor c2 = d1 & c0;
+    Twektor s2 = c1 ^ c2 ^ (p & q);
+    Twektor s3 = c1 & c2;
+    if (regula == REGULA_CONWAY) {
+        // Żywa komórka ma 2 lub 3 sąsiadów, martwa dokładnie 3.
+        *wynik = s1 & ~s2 & ~s3 & (s0 | x);
+        return;
+    }
+    Twektor nowe = {0};
+    for (int n = 0; n <= 8; n++) {
+        int narodziny = (regula >> n) & 1;
+        int przezycie = (regula >> (PRZEZYCIE + n)) & 1;
+        if (!narodziny && !przezycie) {
+            continue;
+        }
+        // Bity, dla których suma wynosi dokładnie 'n'.
+        Twektor rowne = ((n & 1) ? s0 : ~s0) & ((n & 2) ? s1 : ~s1)
+                        & ((n & 4) ? s2 : ~s2) & ((n & 8) ? s3 : ~s3);
+        if (narodziny && przezycie) {
+            nowe |= rowne;
+        }
+        else if (narodziny) {
+            nowe |= rowne & ~x;
+        }
+        else {
+            nowe |= rowne & x;
+        }
+    }
+    *wynik = nowe;
+}
+
+/*  Liczy następną generację dla wiersza 'srodek' planszy bitowej według
+    reguły 'regula', mając wiersze 'gora' i 'dol' nad i pod nim, i zapisuje
+    ją w 'wynik'. Słowa są przetwarzane po kilka naraz.  */
+WPLATANA void krok_wiersza_reguly(const uint64_t* gora, 
+    const uint64_t* srodek, const uint64_t* dol, uint64_t* wynik, int slowa,
+    int regula) {
+
+    Twektor g, gl, gp, x, xl, xp, d, dl, dp, nowe;
+    for (int s = 1; s < slowa - 1; s += SZEROKOSC_WEKTORA) {
+        // Sąsiad z lewej (kolumna o jeden mniejsza) to bit o jeden niższy, 
+        // więc przesuwamy słowa w lewo, dobierając najstarszy bit słowa 
+        // poprzedniego, a dla sąsiada z prawej odwrotnie.
+        memcpy(&g, gora + s, sizeof(g));
+        memcpy(&gl, gora + s - 1, sizeof(gl));
+        memcpy(&gp, gora + s + 1, sizeof(gp));
+        gl = (g << 1) | (gl >> 63);
+        gp = (g >> 1) | (gp << 63);
+        memcpy(&x, srodek + s, sizeof(x));
+        memcpy(&xl, srodek + s - 1, sizeof(xl));
+        memcpy(&xp, srodek + s + 1, sizeof(xp));
+        xl = (x << 1) | (xl >> 63);
+        xp = (x >> 1) | (xp << 63);
+        memcpy(&d, dol + s, sizeof(d));
+        memcpy(&dl, dol + s - 1, sizeof(dl));
+        memcpy(&dp, dol + s + 1, sizeof(dp));
+        dl = (d << 1) | (dl >> 63);
+        dp = (d >> 1) | (dp << 63);
+        Twektor o[3][3] = {{gl, g, gp}, {xl, x, xp}, {dl, d, dp}};
+        nowe_bity(o, &nowe, regula);
+        memcpy(wynik + s, &nowe, sizeof(nowe));
+    }
+}
+
+/*  Funkcja licząca wiersz planszy bitowej.  */
+typedef void (*Tkrok_wiersza)(const uint64_t*, const uint64_t*, 
+    const uint64_t*, uint64_t*, int, int);
+
+/*  Definiuje funkcję 'nazwa' typu 'Tkrok_wiersza', która liczy wiersz 
+    według reguły 'REGULA'. Dla często używanych reguł jest to stała,
+    więc każda z nich dostaje osobny, uproszczony przez kompilator kod.  */
+#define KROK_WIERSZA(nazwa, REGULA) \
+    KLONY_AVX2 void nazwa(const uint64_t* gora, const uint64_t* srodek, \
+        const uint64_t* dol, uint64_t* wynik, int slowa, int regula) { \
+        (void) regula; \
+        krok_wiersza_reguly(gora, srodek, dol, wynik, slowa, REGULA); \
+    }
+
+KROK_WIERSZA(krok_wiersza_conway, REGULA_CONWAY)
+KROK_WIERSZA(krok_wiersza_highlife, REGULA_HIGHLIFE)
+KROK_WIERSZA(krok_wiersza_dzien_i_noc, REGULA_DZIEN_I_NOC)
+KROK_WIERSZA(krok_wiersza_nasiona, REGULA_NASIONA)
+KROK_WIERSZA(krok_wiersza_dowolna, regula)
+
+/*  Przekazuje funkcję liczącą wiersz planszy bitowej według reguły 
+    'regula'.  */
+WEWNETRZNA Tkrok_wiersza wybierz_krok_wiersza(int regula) {
+    switch (regula) {
+        case REGULA_CONWAY: return krok_wiersza_conway;
+        case REGULA_HIGHLIFE: return krok_wiersza_highlife;
+        case REGULA_DZIEN_I_NOC: return krok_wiersza_dzien_i_noc;
+        case REGULA_NASIONA: return krok_wiersza_nasiona;
+        default: return krok_wiersza_dowolna;
+    }
+}
+
+/*  Wypełnia pas wokół torusa 'p' kopią przeciwległych brzegów: kolumna -1
+    dostaje kolumnę 'szerokosc' - 1, kolumna 'szerokosc' kolumnę 0, a wiersze
+    0 i 'wysokosc' + 1 (razem z narożnikami) wiersze 'wysokosc' i 1. Dzięki 
+    temu krok liczy brzegi tak samo jak środek, bez żadnych warunków.  */
+WEWNETRZNA void sklej_bity(Tbity* p) {
+    int ostatnia = p -> szerokosc - 1;
+    int s = p -> szerokosc / 64 + 1; // Słowo z kolumną 'szerokosc'.
+    uint64_t bit = (uint64_t) 1 << (p -> szerokosc % 64);
+    for (int r = 1; r <= p -> wysokosc; r++) {
+        uint64_t* wiersz = wiersz_bitow(p, p -> akt, r);
+        wiersz[0] = (wiersz[ostatnia / 64 + 1] >> (ostatnia % 64)) << 63;
+        wiersz[s] = (wiersz[s] & ~bit) | ((wiersz[1] & 1) ? bit : 0);
+    }
+    size_t dlugosc = (size_t) p -> slowa * sizeof(uint64_t);
+    memcpy(wiersz_bitow(p, p -> akt, 0), 
+        wiersz_bitow(p, p -> akt, p -> wysokosc), dlugosc);
+    memcpy(wiersz_bitow(p, p -> akt, p -> wysokosc + 1), 
+        wiersz_bitow(p, p -> akt, 1), dlugosc);
+}
+
+/*  Zeruje na planszy 'p' o stałych wymiarach wszystkie bity na prawo od 
+    kolumny 'szerokosc' - 1, które krok policzył, bo słowa są przetwarzane
+    całymi wektorami.  */
+WEWNETRZNA void przytnij_bity(Tbity* p) {
+    int s = p -> szerokosc / 64 + 1; // Słowo z kolumną 'szerokosc'.
+    uint64_t maska = ((uint64_t) 1 << (p -> szerokosc % 64)) - 1;
+    for (int r = 1; r <= p -> wysokosc; r++) {
+        uint64_t* wiersz = wiersz_bitow(p, p -> akt, r);
+        wiersz[s] &= maska;
+        for (int i = s + 1; i < p -> slowa - 1; i++) {
+            wiersz[i] = 0;
+        }
+    }
+}
+
+/*  Liczy następną generację na planszy bitowej 'p' według reguły 
+    'regula'.  */
+WEWNETRZNA void krok_bity(Tbity* p, int regula) {
+    if (p -> torus) {
+        sklej_bity(p);
+    }
+    else if (p -> wysokosc == 0 && (bity_przy_brzegu(p) || bity_za_duze(p))) {
+        przesun_bity(p);
+    }
+    Tkrok_wiersza krok_wiersza = wybierz_krok_wiersza(regula);
+    for (int r = 1; r < p -> wiersze - 1; r++) {
+        krok_wiersza(wiersz_bitow(p, p -> akt, r - 1),
+            wiersz_bitow(p, p -> akt, r), wiersz_bitow(p, p -> akt, r + 1),
+            wiersz_bitow(p, p -> nast, r), p -> slowa, regula);
+    }
+    uint64_t* temp = p -> akt;
+    p -> akt = p -> nast;
+    p -> nast = temp;
+    if (p -> wysokosc > 0) {
+        przytnij_bity(p);
+    }
+}
+
+/*  Przekazuje miejsce w tablicy haszującej planszy 's', od którego należy
+    szukać obszaru o współrzędnych 'w' i 'k'.  */
+WEWNETRZNA int skrot_obszaru(Tobszary* s, int w, int k) {
+    uint32_t x = (uint32_t) w * 0x9E3779B1u ^ (uint32_t) k * 0x85EBCA77u;
+    return (int) ((x ^ (x >> 15)) & (uint32_t) s -> maska);
+}
+
+/*  Wstawia obszar 'o' do tablicy haszującej planszy 's', która musi mieć
+    na niego miejsce.  */
+WEWNETRZNA void wstaw_obszar(Tobszary* s, Tobszar* o) {
+    int h = skrot_obszaru(s, o -> w, o -> k);
+    while (s -> indeks[h].obszar != NULL) {
+        h = (h + 1) & s -> maska;
+    }
+    s -> indeks[h].w = o -> w;
+    s -> indeks[h].k = o -> k;
+    s -> indeks[h].obszar = o;
+}
+
+/*  Układa na nowo tablicę haszującą planszy 's' tak, aby była wypełniona
+    najwyżej w połowie.  */
+WEWNETRZNA void przelicz_obszary(Tobszary* s) {
+    int rozmiar = 16;
+    while (rozmiar < 2 * s -> ile) {
+        rozmiar *= 2;
+    }
+    if (rozmiar != s -> maska + 1) {
+        free(s -> indeks);
+        s -> indeks = (Tmiejsce_obszaru*) malloc(
+            (size_t) rozmiar * sizeof(Tmiejsce_obszaru));
+        assert(s -> indeks != NULL);
+        s -> maska = rozmiar - 1;
+    }
+    for (int i = 0; i < rozmiar; i++) {
+        s -> indeks[i].obszar = NULL;
+    }
+    for (int i = 0; i < s -> ile; i++) {
+        wstaw_obszar(s, s -> obszary[i]);
+    }
+}
+
+/*  Inicjalizuje pustą planszę silnika obszarów 's'.  */
+WEWNETRZNA void inicjalizuj_obszary(Tobszary* s) {
+    s -> obszary = NULL;
+    s -> ile = 0;
+    s -> poj = 0;
+    s -> indeks = NULL;
+    s -> maska = -1;
+    s -> aktywne = NULL;
+    s -> ile_aktywnych = 0;
+    s -> poj_aktywnych = 0;
+    s -> kandydaci = NULL;
+    s -> ile_kandydatow = 0;
+    s -> poj_kandydatow = 0;
+    s -> runda = 0;
+    s -> niepewne = 0;
+    memset(s -> puste, 0, sizeof(s -> puste));
+    przelicz_obszary(s);
+}
+
+/*  Zwalnia pamięć zarezerwowaną przez planszę silnika obszarów 's'.  */
+WEWNETRZNA void zwolnij_obszary(Tobszary* s) {
+    for (int i = 0; i < s -> ile; i++) {
+        free(s -> obszary[i]);
+    }
+    free(s -> obszary);
+    free(s -> indeks);
+    free(s -> aktywne);
+    free(s -> kandydaci);
+}
+
+/*  Dopisuje obszar 'o' na koniec tablicy '*tab' o 'ile' elementach
+    i pojemności 'poj', w razie potrzeby ją powiększając.  */
+WEWNETRZNA void dopisz_obszar(Tobszar*** tab, int* ile, int* poj, Tobszar* o) {
+    if (*ile == *poj) {
+        *poj = 2 * *poj + 16;
+        *tab = (Tobszar**) realloc(*tab, (size_t) *poj * sizeof(Tobszar*));
+        assert(*tab != NULL);
+    }
+    (*tab)[(*ile)++] = o;
+}
+
+/*  Przekazuje obszar planszy 's' o współrzędnych 'w' i 'k' albo NULL,
+    jeśli go nie ma.  */
+WEWNETRZNA Tobszar* znajdz_obszar(Tobszary* s, int w, int k) {
+    for (int h = skrot_obszaru(s, w, k); s -> indeks[h].obszar != NULL;
+         h = (h + 1) & s -> maska) {
+        if (s -> indeks[h].w == w && s -> indeks[h].k == k) {
+            return s -> indeks[h].obszar;
+        }
+    }
+    return NULL;
+}
+
+/*  Dodaje do planszy 's' pusty, nieaktywny obszar o współrzędnych 'w'
+    i 'k' i przekazuje go.  */
+WEWNETRZNA Tobszar* dodaj_obszar(Tobszary* s, int w, int k) {
+    Tobszar* o = (Tobszar*) calloc(1, sizeof(Tobszar));
+    assert(o != NULL);
+    o -> w = w;
+    o -> k = k;
+    o -> nr = s -> ile;
+    o -> akt = 0;
+    o -> poprz = 1;
+    dopisz_obszar(&(s -> obszary), &(s -> ile), &(s -> poj), o);
+    if (2 * s -> ile > s -> maska + 1) {
+        przelicz_obszary(s);
+    }
+    else {
+        wstaw_obszar(s, o);
+    }
+    return o;
+}
+
+/*  Usuwa obszar 'o' z planszy 's' i zwalnia go.  */
+WEWNETRZNA void usun_obszar(Tobszary* s, Tobszar* o) {
+    int h = skrot_obszaru(s, o -> w, o -> k);
+    while (s -> indeks[h].obszar != o) {
+        h = (h + 1) & s -> maska;
+    }
+    // Obszary z dalszej części ciągu zajętych miejsc, które mogą stanąć
+    // w powstałej dziurze, są do niej przesuwane, aby wyszukiwanie się
+    // na niej nie zatrzymywało.
+    for (int j = (h + 1) & s -> maska; s -> indeks[j].obszar != NULL;
+         j = (j + 1) & s -> maska) {
+        int d = skrot_obszaru(s, s -> indeks[j].w, s -> indeks[j].k);
+        if (((j - d) & s -> maska) >= ((j - h) & s -> maska)) {
+            s -> indeks[h] = s -> indeks[j];
+            h = j;
+        }
+    }
+    s -> indeks[h].obszar = NULL;
+    s -> obszary[o -> nr] = s -> obszary[--(s -> ile)];
+    s -> obszary[o -> nr] -> nr = o -> nr;
+    free(o);
+}
+
+/*  Zastępuje zawartość planszy 's' żywymi komórkami ze zbioru 'zywe'.
+    Wcześniejsze generacje nie są znane, więc wszystkie obszary stają się
+    aktywne.  */
+WEWNETRZNA void zaladuj_obszary(Tobszary* s, Tzywe* zywe) {
+    for (int i = 0; i < s -> ile; i++) {
+        free(s -> obszary[i]);
+    }
+    s -> ile = 0;
+    przelicz_obszary(s);
+    Tobszar* o = NULL;
+    for (int i = 0; i < zywe -> ile_w; i++) {
+        int tw = nr_kafelka(zywe -> w[i]);
+        for (int j = zywe -> pocz[i]; j < zywe -> pocz[i + 1]; j++) {
+            int tk = nr_kafelka(zywe -> k[j]);
+            if (o == NULL || o -> w != tw || o -> k != tk) {
+                o = znajdz_obszar(s, tw, tk);
+                if (o == NULL) {
+                    o = dodaj_obszar(s, tw, tk);
+                }
+            }
+            o -> stan[o -> akt][w_kafelku(zywe -> w[i])] |=
+                (uint64_t) 1 << w_kafelku(zywe -> k[j]);
+        }
+    }
+    s -> ile_aktywnych = 0;
+    for (int i = 0; i < s -> ile; i++) {
+        s -> obszary[i] -> zmiany = ROZNI_SIE_1 | ROZNI_SIE_2;
+        dopisz_obszar(&(s -> aktywne), &(s -> ile_aktywnych),
+            &(s -> poj_aktywnych), s -> obszary[i]);
+    }
+    s -> niepewne = 1;
+}
+
+/*  Porównuje położenie obszarów na potrzeby funkcji 'qsort'.  */
+WEWNETRZNA int porownaj_obszary(const void* a, const void* b) {
+    const Tobszar* x = *(const Tobszar* const*) a;
+    const Tobszar* y = *(const Tobszar* const*) b;
+    if (x -> w != y -> w) {
+        return x -> w < y -> w ? -1 : 1;
+    }
+    return (x -> k > y -> k) - (x -> k < y -> k);
+}
+
+/*  Zapisuje żywe komórki bieżącej generacji planszy 's' do zbioru
+    'zywe'.  */
+WEWNETRZNA void zapisz_obszary(Tobszary* s, Tzywe* zywe) {
+    wyczysc_zywe(zywe);
+    if (s -> ile == 0) {
+        return;
+    }
+    qsort(s -> obszary, (size_t) s -> ile, sizeof(Tobszar*),
+        porownaj_obszary);
+    for (int i = 0; i < s -> ile; i++) {
+        s -> obszary[i] -> nr = i;
+    }
+    int n = 0;
+    for (int i = 0, j = 0; i < s -> ile; i = j) {
+        // Obszary od 'i' do 'j - 1' leżą w tym samym pasie wierszy.
+        while (j < s -> ile && s -> obszary[j] -> w == s -> obszary[i] -> w) {
+            j++;
+        }
+        for (int r = 0; r < BOK_KAFELKA; r++) {
+            int ile = 0;
+            for (int t = i; t < j; t++) {
+                Tobszar* o = s -> obszary[t];
+                ile += ile_bitow(o -> stan[o -> akt][r]);
+            }
+            if (ile == 0) {
+                continue;
+            }
+            zarezerwuj(zywe, zywe -> ile_w + 1, n + ile);
+            zywe -> w[zywe -> ile_w] = BOK_KAFELKA * s -> obszary[i] -> w + r;
+            for (int t = i; t < j; t++) {
+                Tobszar* o = s -> obszary[t];
+                for (uint64_t x = o -> stan[o -> akt][r]; x != 0; x &= x - 1) {
+                    zywe -> k[n++] = BOK_KAFELKA * o -> k + najnizszy_bit(x);
+                }
+            }
+            zakoncz_wiersz(zywe, n);
+        }
+    }
+}
+
+/*  Liczy następną generację obszaru 'sasiedzi[1][1]' według reguły 
+    'regula' na podstawie bieżących generacji jego otoczenia 'sasiedzi' 
+    (NULL oznacza brak obszaru) i zapisuje ją w wolnym miejscu jego tablicy
+    'stan'. Sąsiedzi są sumowani tak samo jak w funkcji 'krok_wiersza_reguly',
+    tyle że słowa leżą jedno pod drugim.  */
+WPLATANA void licz_obszar_reguly(Tobszary* s, Tobszar* sasiedzi[3][3], 
+    int regula) {
+
+    const uint64_t* g[3][3];
+    for (int a = 0; a < 3; a++) {
+        for (int b = 0; b < 3; b++) {
+            Tobszar* o = sasiedzi[a][b];
+            g[a][b] = o == NULL ? s -> puste : o -> stan[o -> akt];
+        }
+    }
+    // Słowa wraz z wierszem nad i pod obszarem oraz słowa z obszarów po
+    // lewej i po prawej, z których przesuwane są skrajne bity.
+    uint64_t x[BOK_KAFELKA + 2], xl[BOK_KAFELKA + 2], xp[BOK_KAFELKA + 2];
+    x[0] = g[0][1][BOK_KAFELKA - 1];
+    xl[0] = g[0][0][BOK_KAFELKA - 1];
+    xp[0] = g[0][2][BOK_KAFELKA - 1];
+    for (int r = 0; r < BOK_KAFELKA; r++) {
+        x[r + 1] = g[1][1][r];
+        xl[r + 1] = g[1][0][r];
+        xp[r + 1] = g[1][2][r];
+    }
+    x[BOK_KAFELKA + 1] = g[2][1][0];
+    xl[BOK_KAFELKA + 1] = g[2][0][0];
+    xp[BOK_KAFELKA + 1] = g[2][2][0];
+    for (int r = 0; r < BOK_KAFELKA + 2; r++) {
+        xl[r] = (x[r] << 1) | (xl[r] >> 63);
+        xp[r] = (x[r] >> 1) | (xp[r] << 63);
+    }
+    Tobszar* o = sasiedzi[1][1];
+    uint64_t* nast = o -> stan[3 - o -> akt - o -> poprz];
+    Twektor gl, gs, gp, xsl, xs, xsp, dl, ds, dp, nowe;
+    for (int r = 0; r < BOK_KAFELKA; r += SZEROKOSC_WEKTORA) {
+        memcpy(&gl, xl + r, sizeof(gl));
+        memcpy(&gs, x + r, sizeof(gs));
+        memcpy(&gp, xp + r, sizeof(gp));
+        memcpy(&xsl, xl + r + 1, sizeof(xsl));
+        memcpy(&xs, x + r + 1, sizeof(xs));
+        memcpy(&xsp, xp + r + 1, sizeof(xsp));
+        memcpy(&dl, xl + r + 2, sizeof(dl));
+        memcpy(&ds, x + r + 2, sizeof(ds));
+        memcpy(&dp, xp + r + 2, sizeof(dp));
+        Twektor otoczenie[3][3] = {{gl, gs, gp}, {xsl, xs, xsp}, 
+                                   {dl, ds, dp}};
+        nowe_bity(otoczenie, &nowe, regula);
+        memcpy(nast + r, &nowe, sizeof(nowe));
+    }
+    size_t rozmiar = BOK_KAFELKA * sizeof(uint64_t);
+    o -> nowe_zmiany = 
+        (memcmp(nast, o -> stan[o -> akt], rozmiar) != 0 ? ROZNI_SIE_1 : 0)
+        | (memcmp(nast, o -> stan[o -> poprz], rozmiar) != 0 ? ROZNI_SIE_2 : 0);
+}
+
+/*  Funkcja licząca obszar planszy obszarów.  */
+typedef void (*Tlicz_obszar)(Tobszary*, Tobszar* [3][3], int);
+
+/*  Definiuje funkcję 'nazwa' typu 'Tlicz_obszar', która liczy obszar 
+    według reguły 'REGULA', tak jak 'KROK_WIERSZA' dla planszy bitowej.  */
+#define LICZ_OBSZAR(nazwa, REGULA) \
+    KLONY_AVX2 void nazwa(Tobszary* s, Tobszar* sasiedzi[3][3], \
+        int regula) { \
+        (void) regula; \
+        licz_obszar_reguly(s, sasiedzi, REGULA); \
+    }
+
+LICZ_OBSZAR(licz_obszar_conway, REGULA_CONWAY)
+LICZ_OBSZAR(licz_obszar_highlife, REGULA_HIGHLIFE)
+LICZ_OBSZAR(licz_obszar_dzien_i_noc, REGULA_DZIEN_I_NOC)
+LICZ_OBSZAR(licz_obszar_nasiona, REGULA_NASIONA)
+LICZ_OBSZAR(licz_obszar_dowolna, regula)
+
+/*  Przekazuje funkcję liczącą obszar według reguły 'regula'.  */
+WEWNETRZNA Tlicz_obszar wybierz_licz_obszar(int regula) {
+    switch (regula) {
+        case REGULA_CONWAY: return licz_obszar_conway;
+        case REGULA_HIGHLIFE: return licz_obszar_highlife;
+        case REGULA_DZIEN_I_NOC: return licz_obszar_dzien_i_noc;
+        case REGULA_NASIONA: return licz_obszar_nasiona;
+        default: return licz_obszar_dowolna;
+    }
+}
+
+/*  Dopisuje do kandydatów planszy 's' aktywny obszar 'o' i jego sąsiadów.
+    Brakujący sąsiad jest tworzony tylko wtedy, gdy w bieżącej lub
+    poprzedniej generacji 'o' ma żywe komórki na stykającym się z nim
+    brzegu, bo tylko wtedy jego otoczenie mogło się zmienić.  */
+WEWNETRZNA void dodaj_kandydatow(Tobszary* s, Tobszar* o) {
+    uint64_t* akt = o -> stan[o -> akt];
+    uint64_t* poprz = o -> stan[o -> poprz];
+    uint64_t gora = akt[0] | poprz[0];
+    uint64_t dol = akt[BOK_KAFELKA - 1] | poprz[BOK_KAFELKA - 1];
+    uint64_t lewa = 0, prawa = 0;
+    for (int r = 0; r < BOK_KAFELKA; r++) {
+        lewa |= (akt[r] | poprz[r]) & 1;
+        prawa |= (akt[r] | poprz[r]) >> 63;
+    }
+    int brzeg[3][3] = {
+        {(gora & 1) != 0, gora != 0, (gora >> 63) != 0},
+        {lewa != 0, 1, prawa != 0},
+        {(dol & 1) != 0, dol != 0, (dol >> 63) != 0}
+    };
+    for (int a = 0; a < 3; a++) {
+        for (int b = 0; b < 3; b++) {
+            Tobszar* n = o;
+            if (a != 1 || b != 1) {
+                n = znajdz_obszar(s, o -> w + a - 1, o -> k + b - 1);
+                if (n == NULL && brzeg[a][b]) {
+                    n = dodaj_obszar(s, o -> w + a - 1, o -> k + b - 1);
+                }
+            }
+            if (n != NULL && n -> runda != s -> runda) {
+                n -> runda = s -> runda;
+                dopisz_obszar(&(s -> kandydaci), &(s -> ile_kandydatow),
+                    &(s -> poj_kandydatow), n);
+            }
+        }
+    }
+}
+
+/*  Liczy następną generację na planszy 's'. Kandydat, wokół którego nic
+    się nie zmieniło, zostaje taki, jaki jest. Jeśli otoczenie kandydata
+    jest takie samo jak dwie generacje temu, to jego następna generacja
+    jest taka sama jak poprzednia, więc wystarczy je zamienić miejscami.
+    Tylko pozostali kandydaci są liczeni. Nowe generacje są zatwierdzane
+    dopiero po obejrzeniu wszystkich kandydatów, bo ich otoczenia na siebie
+    zachodzą. Komórki zmieniają się według reguły 'regula'.  */
+WEWNETRZNA void krok_obszarow(Tobszary* s, int regula) {
+    Tlicz_obszar licz_obszar = wybierz_licz_obszar(regula);
+    s -> runda++;
+    s -> ile_kandydatow = 0;
+    for (int i = 0; i < s -> ile_aktywnych; i++) {
+        dodaj_kandydatow(s, s -> aktywne[i]);
+    }
+    for (int i = 0; i < s -> ile_kandydatow; i++) {
+        Tobszar* o = s -> kandydaci[i];
+        Tobszar* sasiedzi[3][3];
+        int zmiany = 0;
+        for (int a = 0; a < 3; a++) {
+            for (int b = 0; b < 3; b++) {
+                sasiedzi[a][b] = a == 1 && b == 1 ? o
+                    : znajdz_obszar(s, o -> w + a - 1, o -> k + b - 1);
+                if (sasiedzi[a][b] != NULL) {
+                    zmiany |= sasiedzi[a][b] -> zmiany;
+                }
+            }
+        }
+        if (s -> niepewne) {
+            zmiany = ROZNI_SIE_1 | ROZNI_SIE_2;
+        }
+        if (!(zmiany & ROZNI_SIE_1)) {
+            o -> decyzja = OBSZAR_USPIONY;
+        }
+        else if (!(zmiany & ROZNI_SIE_2)) {
+            o -> decyzja = OBSZAR_OKRES_2;
+        }
+        else {
+            o -> decyzja = OBSZAR_LICZONY;
+            licz_obszar(s, sasiedzi, regula);
+        }
+    }
+    s -> ile_aktywnych = 0;
+    for (int i = 0; i < s -> ile_kandydatow; i++) {
+        Tobszar* o = s -> kandydaci[i];
+        int akt = o -> akt;
+        switch (o -> decyzja) {
+            case OBSZAR_USPIONY:
+                o -> zmiany = 0;
+                break;
+            case OBSZAR_OKRES_2:
+                o -> akt = o -> poprz;
+                o -> poprz = akt;
+                o -> zmiany &= ROZNI_SIE_1;
+                break;
+            case OBSZAR_LICZONY:
+                o -> akt = 3 - akt - o -> poprz;
+                o -> poprz = akt;
+                o -> zmiany = o -> nowe_zmiany;
+                if (s -> niepewne) {
+                    o -> zmiany |= ROZNI_SIE_2;
+                }
+                break;
+            default: assert(0); // Błąd.
+        }
+        if (o -> zmiany != 0) {
+            dopisz_obszar(&(s -> aktywne), &(s -> ile_aktywnych),
+                &(s -> poj_aktywnych), o);
+            continue;
+        }
+        // Obszar bez zmian, w którym nie ma żywych komórek, był pusty
+        // przez trzy generacje i jest zbędny.
+        uint64_t zywe = 0;
+        for (int r = 0; r < BOK_KAFELKA; r++) {
+            zywe |= o -> stan[o -> akt][r];
+        }
+        if (zywe == 0) {
+            usun_obszar(s, o);
+        }
+    }
+    s -> niepewne = 0;
+}
+
+/*  Przekazuje wynik mieszania ćwiartek 'a', 'b', 'c' i 'd' węzła.  */
+WEWNETRZNA uint32_t hl_skrot(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    uint64_t x = a * 0x9E3779B97F4A7C15u;
+    x = (x ^ b) * 0xBF58476D1CE4E5B9u;
+    x = (x ^ c) * 0x94D049BB133111EBu;
+    x = (x ^ d) * 0x9E3779B97F4A7C15u;
+    return (uint32_t) (x >> 32);
+}
+
+/*  Układa na nowo kubełki tablicy haszującej drzewa 'h' tak, aby było ich
+    co najmniej tyle, ile miejsc na węzły.  */
+WEWNETRZNA void hl_przelicz_kubelki(Thashlife* h) {
+    uint32_t ile = 1;
+    while (ile < h -> poj) {
+        ile *= 2;
+    }
+    free(h -> kubelki);
+    h -> kubelki = (uint32_t*) malloc((size_t) ile * sizeof(uint32_t));
+    assert(h -> kubelki != NULL);
+    h -> maska = ile - 1;
+    for (uint32_t i = 0; i < ile; i++) {
+        h -> kubelki[i] = BRAK;
+    }
+    for (uint32_t x = 2; x < h -> ile; x++) {
+        Twezel* w = &(h -> wezly[x]);
+        if (w -> poziom > 0) {
+            uint32_t i = hl_skrot(w -> lg, w -> pg, w -> ld, w -> pd) 
+                         & h -> maska;
+            w -> nast_h = h -> kubelki[i];
+            h -> kubelki[i] = x;
+        }
+    }
+}
+
+/*  Powiększa dwukrotnie tablicę węzłów drzewa 'h'.  */
+WEWNETRZNA void hl_powieksz(Thashlife* h) {
+    h -> poj *= 2;
+    h -> wezly = (Twezel*) realloc(
+        h -> wezly, (size_t) h -> poj * sizeof(Twezel));
+    assert(h -> wezly != NULL);
+    hl_przelicz_kubelki(h);
+}
+
+/*  Zaznacza węzeł 'x' i wszystkie jego potomki jako osiągalne.  */
+WEWNETRZNA void hl_zaznacz(Thashlife* h, uint32_t x) {
+    while (h -> wezly[x].poziom > 0 && !(h -> wezly[x].znacznik)) {
+        h -> wezly[x].znacznik = 1;
+        hl_zaznacz(h, h -> wezly[x].lg);
+        hl_zaznacz(h, h -> wezly[x].pg);
+        hl_zaznacz(h, h -> wezly[x].ld);
+        x = h -> wezly[x].pd;
+    }
+}
+
+/*  Odśmieca tablicę węzłów drzewa 'h': zostawia tylko węzły osiągalne z 
+    korzenia, z pustych węzłów i ze stosu węzłów w trakcie obliczeń. 
+    Zapamiętane wyniki wskazujące na usunięte węzły są zapominane.  */
+WEWNETRZNA void hl_odsmiec(Thashlife* h) {
+    for (uint32_t x = 0; x < h -> ile; x++) {
+        h -> wezly[x].znacznik = 0;
+    }
+    hl_zaznacz(h, h -> korzen);
+    for (int i = 0; i <= MAKS_POZIOM; i++) {
+        if (h -> puste[i] != BRAK) {
+            hl_zaznacz(h, h -> puste[i]);
+        }
+    }
+    for (int i = 0; i < h -> ile_stos; i++) {
+        hl_zaznacz(h, h -> stos[i]);
+    }
+    // Wyniki są zawsze co najmniej poziomu 1, więc wystarczy sprawdzić,
+    // czy zostały zaznaczone.
+    for (uint32_t x = 2; x < h -> ile; x++) {
+        Twezel* w = &(h -> wezly[x]);
+        if (w -> znacznik) {
+            if (w -> wynik != BRAK && !(h -> wezly[w -> wynik].znacznik)) {
+                w -> wynik = BRAK;
+            }
+            if (w -> krok_j >= 0 && !(h -> wezly[w -> wynik_j].znacznik)) {
+                w -> krok_j = -1;
+            }
+        }
+    }
+    h -> wolne = BRAK;
+    h -> zajete = 2;
+    for (uint32_t x = 2; x < h -> ile; x++) {
+        Twezel* w = &(h -> wezly[x]);
+        if (w -> znacznik) {
+            h -> zajete++;
+        }
+        else if (w -> poziom > 0) {
+            w -> poziom = -1;
+            w -> nast_h = h -> wolne;
+            h -> wolne = x;
+        }
+    }
+    hl_przelicz_kubelki(h);
+    h -> odsmiecania++;
+}
+
+/*  Przekazuje numer nowego, niezainicjalizowanego węzła. Gdy liczba węzłów
+    dochodzi do limitu, najpierw odśmieca tablicę. Limit jest miękki: jeśli
+    odśmiecanie zwolni za mało miejsca, tablica i tak rośnie.  */
+WEWNETRZNA uint32_t hl_przydziel(Thashlife* h) {
+    if (h -> wolne == BRAK && h -> ile == h -> poj) {
+        if (h -> poj < h -> limit) {
+            hl_powieksz(h);
+        }
+        else {
+            hl_odsmiec(h);
+            if (h -> zajete > h -> poj / 4 * 3) {
+                hl_powieksz(h);
+            }
+        }
+    }
+    uint32_t x;
+    if (h -> wolne != BRAK) {
+        x = h -> wolne;
+        h -> wolne = h -> wezly[x].nast_h;
+    }
+    else {
+        x = h -> ile++;
+    }
+    h -> zajete++;
+    return x;
+}
+
+/*  Przekazuje jedyny węzeł o ćwiartkach 'a', 'b', 'c' i 'd' (w kolejności:
+    lewa górna, prawa górna, lewa dolna, prawa dolna), w razie potrzeby 
+    tworząc go. Ćwiartki muszą być osiągalne dla odśmiecania.  */
+WEWNETRZNA uint32_t hl_wezel(Thashlife* h, uint32_t a, uint32_t b, uint32_t c, 
+    uint32_t d) {
+
+    uint32_t skrot = hl_skrot(a, b, c, d);
+    uint32_t x = h -> kubelki[skrot & h -> maska];
+    while (x != BRAK) {
+        Twezel* w = &(h -> wezly[x]);
+        if (w -> lg == a && w -> pg == b && w -> ld == c && w -> pd == d) {
+            return x;
+        }
+        x = w -> nast_h;
+    }
+    x = hl_przydziel(h);
+    Twezel* w = &(h -> wezly[x]);
+    w -> lg = a;
+    w -> pg = b;
+    w -> ld = c;
+    w -> pd = d;
+    w -> poziom = (int8_t) (h -> wezly[a].poziom + 1);
+    w -> wynik = BRAK;
+    w -> krok_j = -1;
+    w -> znacznik = 0;
+    w -> nast_h = h -> kubelki[skrot & h -> maska];
+    h -> kubelki[skrot & h -> maska] = x;
+    return x;
+}
+
+/*  Przekazuje pusty węzeł poziomu 'poziom'.  */
+WEWNETRZNA uint32_t hl_pusty(Thashlife* h, int poziom) {
+    // Pusty węzeł poziomu 0 (martwa komórka) zawsze istnieje.
+    int i = poziom;
+    while (h -> puste[i] == BRAK) {
+        i--;
+    }
+    for (; i < poziom; i++) {
+        uint32_t e = h -> puste[i];
+        h -> puste[i + 1] = hl_wezel(h, e, e, e, e);
+    }
+    return h -> puste[poziom];
+}
+
+/*  Sprawdza, czy węzeł 'x' jest pusty.  */
+WEWNETRZNA int hl_czy_pusty(Thashlife* h, uint32_t x) {
+    return x == h -> puste[h -> wezly[x].poziom];
+}
+
+/*  Odkłada węzeł 'x' na stos węzłów chronionych przed odśmiecaniem 
+    i przekazuje go.  */
+WEWNETRZNA uint32_t hl_chron(Thashlife* h, uint32_t x) {
+    if (h -> ile_stos == h -> poj_stos) {
+        h -> poj_stos = 2 * h -> poj_stos + 64;
+        h -> stos = (uint32_t*) realloc(
+            h -> stos, (size_t) h -> poj_stos * sizeof(uint32_t));
+        assert(h -> stos != NULL);
+    }
+    h -> stos[h -> ile_stos++] = x;
+    return x;
+}
+
+/*  Liczy z tabeli środek 2 x 2 węzła 'x' poziomu 2 po jednej generacji.  */
+WEWNETRZNA uint32_t hl_krok_bazowy(Thashlife* h, uint32_t x) {
+    Twezel n = h -> wezly[x];
+    uint32_t cw[4] = {n.lg, n.pg, n.ld, n.pd};
+    int indeks = 0;
+    for (int i = 0; i < 4; i++) {
+        Twezel c = h -> wezly[cw[i]];
+        // Ćwiartka 'i' zaczyna się w wierszu 2 * (i / 2) i kolumnie 
+        // 2 * (i % 2) kwadratu 4 x 4, którego komórka (r, k) to bit 4r + k.
+        int b = 8 * (i / 2) + 2 * (i % 2);
+        indeks |= (int) ((c.lg << b) | (c.pg << (b + 1)) 
+                         | (c.ld << (b + 4)) | (c.pd << (b + 5)));
+    }
+    int w = h -> tabela[indeks];
+    return hl_wezel(h, w & 1, (w >> 1) & 1, (w >> 2) & 1, (w >> 3) & 1);
+}
+
+/*  Przekazuje środek węzła 'x' (węzeł o poziom niższy).  */
+WEWNETRZNA uint32_t hl_srodek(Thashlife* h, uint32_t x) {
+    Twezel n = h -> wezly[x];
+    return hl_wezel(h, h -> wezly[n.lg].pd, h -> wezly[n.pg].ld,
+        h -> wezly[n.ld].pg, h -> wezly[n.pd].lg);
+}
+
+/*  Przekazuje środek węzła 'x' poziomu 'k' (czyli węzeł poziomu 'k - 1')
+    po 2^j generacjach, gdzie j <= k - 2. Wyniki są zapamiętywane 
+    w węzłach, więc powtarzające się fragmenty wzoru liczy się raz.  */
+WEWNETRZNA uint32_t hl_krok(Thashlife* h, uint32_t x, int j) {
+    int k = h -> wezly[x].poziom;
+    if (hl_czy_pusty(h, x)) {
+        return hl_pusty(h, k - 1);
+    }
+    if (j == k - 2 && h -> wezly[x].wynik != BRAK) {
+        return h -> wezly[x].wynik;
+    }
+    if (j < k - 2 && h -> wezly[x].krok_j == j) {
+        return h -> wezly[x].wynik_j;
+    }
+    if (k == 2) {
+        uint32_t wynik = hl_krok_bazowy(h, x);
+        h -> wezly[x].wynik = wynik;
+        return wynik;
+    }
+    int dno = h -> ile_stos;
+    Twezel n = h -> wezly[x];
+    Twezel lg = h -> wezly[n.lg], pg = h -> wezly[n.pg];
+    Twezel ld = h -> wezly[n.ld], pd = h -> wezly[n.pd];
+    // Dziewięć zachodzących na siebie kwadratów poziomu k - 1.
+    uint32_t kw[9];
+    kw[0] = n.lg;
+    kw[1] = hl_chron(h, hl_wezel(h, lg.pg, pg.lg, lg.pd, pg.ld));
+    kw[2] = n.pg;
+    kw[3] = hl_chron(h, hl_wezel(h, lg.ld, lg.pd, ld.lg, ld.pg));
+    kw[4] = hl_chron(h, hl_wezel(h, lg.pd, pg.ld, ld.pg, pd.lg));
+    kw[5] = hl_chron(h, hl_wezel(h, pg.ld, pg.pd, pd.lg, pd.pg));
+    kw[6] = n.ld;
+    kw[7] = hl_chron(h, hl_wezel(h, ld.pg, pd.lg, ld.pd, pd.ld));
+    kw[8] = n.pd;
+    // Ich środki poziomu k - 2: przesunięte o 2^(k - 3) generacji przy 
+    // pełnej prędkości, a w przeciwnym razie bez zmian.
+    uint32_t r[9];
+    for (int i = 0; i < 9; i++) {
+        r[i] = hl_chron(h, j == k - 2 ? hl_krok(h, kw[i], k - 3) 
+                                      : hl_srodek(h, kw[i]));
+    }
+    // Cztery kwadraty poziomu k - 1 złożone ze środków i ich dalsze kroki.
+    int krok = j == k - 2 ? k - 3 : j;
+    uint32_t c[4];
+    for (int i = 0; i < 4; i++) {
+        int a = i / 2 * 3 + i % 2; // Lewa górna ćwiartka w siatce 3 x 3.
+        uint32_t kwadrat = hl_chron(h, 
+            hl_wezel(h, r[a], r[a + 1], r[a + 3], r[a + 4]));
+        c[i] = hl_chron(h, hl_krok(h, kwadrat, krok));
+    }
+    uint32_t wynik = hl_wezel(h, c[0], c[1], c[2], c[3]);
+    h -> ile_stos = dno;
+    if (j == k - 2) {
+        h -> wezly[x].wynik = wynik;
+    }
+    else {
+        h -> wezly[x].wynik_j = wynik;
+        h -> wezly[x].krok_j = (int8_t) j;
+    }
+    return wynik;
+}
+
+/*  Sprawdza, czy wszystkie żywe komórki węzła 'x' leżą w jego środku, czyli
+    w kwadracie o połowę mniejszym o tym samym środku.  */
+WEWNETRZNA int hl_w_srodku(Thashlife* h, uint32_t x) {
+    Twezel n = h -> wezly[x];
+    Twezel lg = h -> wezly[n.lg], pg = h -> wezly[n.pg];
+    Twezel ld = h -> wezly[n.ld], pd = h -> wezly[n.pd];
+    return hl_czy_pusty(h, lg.lg) && hl_czy_pusty(h, lg.pg) 
+        && hl_czy_pusty(h, lg.ld) && hl_czy_pusty(h, pg.lg) 
+        && hl_czy_pusty(h, pg.pg) && hl_czy_pusty(h, pg.pd)
+        && hl_czy_pusty(h, ld.lg) && hl_czy_pusty(h, ld.ld) 
+        && hl_czy_pusty(h, ld.pd) && hl_czy_pusty(h, pd.pg) 
+        && hl_czy_pusty(h, pd.ld) && hl_czy_pusty(h, pd.pd);
+}
+
+/*  Sprawdza, czy wszystkie żywe komórki węzła 'x' leżą w środku jego
+    środka, czyli w kwadracie cztery razy mniejszym o tym samym środku.  */
+WEWNETRZNA int hl_wysrodkowany(Thashlife* h, uint32_t x) {
+    if (!hl_w_srodku(h, x)) {
+        return 0;
+    }
+    Twezel n = h -> wezly[x];
+    Twezel a = h -> wezly[h -> wezly[n.lg].pd];
+    Twezel b = h -> wezly[h -> wezly[n.pg].ld];
+    Twezel c = h -> wezly[h -> wezly[n.ld].pg];
+    Twezel d = h -> wezly[h -> wezly[n.pd].lg];
+    return hl_czy_pusty(h, a.lg) && hl_czy_pusty(h, a.pg) 
+        && hl_czy_pusty(h, a.ld) && hl_czy_pusty(h, b.lg) 
+        && hl_czy_pusty(h, b.pg) && hl_czy_pusty(h, b.pd)
+        && hl_czy_pusty(h, c.lg) && hl_czy_pusty(h, c.ld) 
+        && hl_czy_pusty(h, c.pd) && hl_czy_pusty(h, d.pg) 
+        && hl_czy_pusty(h, d.ld) && hl_czy_pusty(h, d.pd);
+}
+
+/*  Otacza korzeń drzewa 'h' pustym pasem, podwajając bok jego kwadratu.  */
+WEWNETRZNA void hl_rozszerz(Thashlife* h) {
+    Twezel n = h -> wezly[h -> korzen];
+    int k = n.poziom;
+    uint32_t e = hl_pusty(h, k - 1);
+    int dno = h -> ile_stos;
+    uint32_t a = hl_chron(h, hl_wezel(h, e, e, e, n.lg));
+    uint32_t b = hl_chron(h, hl_wezel(h, e, e, n.pg, e));
+    uint32_t c = hl_chron(h, hl_wezel(h, e, n.ld, e, e));
+    uint32_t d = hl_chron(h, hl_wezel(h, n.pd, e, e, e));
+    h -> korzen = hl_wezel(h, a, b, c, d);
+    h -> ile_stos = dno;
+    h -> min_w -= 1LL << (k - 1);
+    h -> min_k -= 1LL << (k - 1);
+}
+
+/*  Zmniejsza korzeń drzewa 'h' do jego środka, dopóki nie zgubi to żadnej 
+    żywej komórki.  */
+WEWNETRZNA void hl_przytnij(Thashlife* h) {
+    while (h -> wezly[h -> korzen].poziom > 3 
+           && hl_w_srodku(h, h -> korzen)) {
+        int k = h -> wezly[h -> korzen].poziom;
+        h -> korzen = hl_srodek(h, h -> korzen);
+        h -> min_w += 1LL << (k - 2);
+        h -> min_k += 1LL << (k - 2);
+    }
+}
+
+/*  Oblicza 'ile' kolejnych generacji drzewa 'h'. Liczba generacji jest 
+    rozkładana na potęgi dwójki i każda z nich jest liczona jednym 
+    wywołaniem 'hl_krok', więc czas rośnie z logarytmem 'ile'.  */
+WEWNETRZNA void hl_generacje(Thashlife* h, long long ile) {
+    for (int j = 0; ile > 0; j++, ile >>= 1) {
+        if (ile & 1) {
+            while (h -> wezly[h -> korzen].poziom < j + 3 
+                   || !hl_wysrodkowany(h, h -> korzen)) {
+                hl_rozszerz(h);
+            }
+            int k = h -> wezly[h -> korzen].poziom;
+            h -> korzen = hl_krok(h, h -> korzen, j);
+            h -> min_w += 1LL << (k - 2);
+            h -> min_k += 1LL << (k - 2);
+        }
+    }
+    hl_przytnij(h);
+}
+
+/*  Przestawia komórki z tablicy 'komorki' o indeksach od 'od' do 'do_' 
+    (bez niego) tak, aby na początku były te, których współrzędna 'os' 
+    (0 to wiersz, 1 to kolumna) jest mniejsza od 'pol'. Przekazuje indeks
+    pierwszej z pozostałych.  */
+WEWNETRZNA size_t hl_podziel(uint32_t* komorki, size_t od, size_t do_, int os, 
+    uint32_t pol) {
+
+    size_t i = od;
+    for (size_t j = od; j < do_; j++) {
+        if (komorki[2 * j + (size_t) os] < pol) {
+            uint32_t w = komorki[2 * j], k = komorki[2 * j + 1];
+            komorki[2 * j] = komorki[2 * i];
+            komorki[2 * j + 1] = komorki[2 * i + 1];
+            komorki[2 * i] = w;
+            komorki[2 * i + 1] = k;
+            i++;
+        }
+    }
+    return i;
+}
+
+/*  Buduje węzeł poziomu 'poziom' z 'ile' komórek z tablicy 'komorki', 
+    której kolejne pary to wiersz i kolumna względem lewego górnego rogu 
+    węzła. Kolejność komórek w tablicy jest zmieniana.  */
+WEWNETRZNA uint32_t hl_buduj(Thashlife* h, uint32_t* komorki, size_t ile, 
+    int poziom) {
+
+    if (ile == 0) {
+        return hl_pusty(h, poziom);
+    }
+    if (poziom == 0) {
+        return 1;
+    }
+    uint32_t pol = (uint32_t) 1 << (poziom - 1);
+    // Dzielimy komórki na ćwiartki jak w sortowaniu szybkim: najpierw 
+    // względem wiersza, a potem każdą z połówek względem kolumny.
+    size_t granice[5];
+    granice[0] = 0;
+    granice[2] = hl_podziel(komorki, 0, ile, 0, pol);
+    granice[1] = hl_podziel(komorki, 0, granice[2], 1, pol);
+    granice[3] = hl_podziel(komorki, granice[2], ile, 1, pol);
+    granice[4] = ile;
+    int dno = h -> ile_stos;
+    uint32_t c[4];
+    for (int i = 0; i < 4; i++) {
+        for (size_t j = granice[i]; j < granice[i + 1]; j++) {
+            komorki[2 * j] -= (uint32_t) (i / 2) * pol;
+            komorki[2 * j + 1] -= (uint32_t) (i % 2) * pol;
+        }
+        c[i] = hl_chron(h, hl_buduj(h, komorki + 2 * granice[i], 
+            granice[i + 1] - granice[i], poziom - 1));
+    }
+    uint32_t wynik = hl_wezel(h, c[0], c[1], c[2], c[3]);
+    h -> ile_stos = dno;
+    return wynik;
+}
+
+/*  Buduje drzewo 'h' z żywych komórek ze zbioru 'zywe'.  */
+WEWNETRZNA void hl_zaladuj(Thashlife* h, Tzywe* zywe) {
+    h -> korzen = hl_pusty(h, 3);
+    h -> min_w = 0;
+    h -> min_k = 0;
+    if (zywe -> ile_w == 0) {
+        return;
+    }
+    int gora_w = zywe -> w[0];
+    int dol_w = zywe -> w[zywe -> ile_w - 1];
+    int lewa_k = INT_MAX;
+    int prawa_k = INT_MIN;
+    for (int i = 0; i < zywe -> ile_w; i++) {
+        if (zywe -> k[zywe -> pocz[i]] < lewa_k) {
+            lewa_k = zywe -> k[zywe -> pocz[i]];
+        }
+        if (zywe -> k[zywe -> pocz[i + 1] - 1] > prawa_k) {
+            prawa_k = zywe -> k[zywe -> pocz[i + 1] - 1];
+        }
+    }
+    long long bok = (long long) dol_w - gora_w + 1;
+    if ((long long) prawa_k - lewa_k + 1 > bok) {
+        bok = (long long) prawa_k - lewa_k + 1;
+    }
+    int poziom = 3;
+    while ((1LL << poziom) < bok) {
+        poziom++;
+    }
+    size_t ile = (size_t) ile_zywych(zywe);
+    uint32_t* komorki = (uint32_t*) malloc(2 * ile * sizeof(uint32_t));
+    assert(komorki != NULL);
+    for (int i = 0; i < zywe -> ile_w; i++) {
+        for (int j = zywe -> pocz[i]; j < zywe -> pocz[i + 1]; j++) {
+            komorki[2 * j] = (uint32_t) ((long long) zywe -> w[i] - gora_w);
+            komorki[2 * j + 1] = (uint32_t) ((long long) zywe -> k[j] - lewa_k);
+        }
+    }
+    h -> korzen = hl_buduj(h, komorki, ile, poziom);
+    h -> min_w = gora_w;
+    h -> min_k = lewa_k;
+    free(komorki);
+}
+
+/*  Zaznacza w oknie 'okno' żywe komórki węzła 'x' poziomu 'poziom', którego
+    lewy górny róg leży w wierszu 'w' i kolumnie 'k'.  */
+WEWNETRZNA void hl_wypelnij(Thashlife* h, uint32_t x, int poziom, long long w, 
+    long long k, Tokno okno, char* ekran) {
+
+    long long bok = 1LL << poziom;
+    if (hl_czy_pusty(h, x) || w >= okno.w + WIERSZE || k >= okno.k + KOLUMNY
+        || w + bok <= okno.w || k + bok <= okno.k) {
+        return;
+    }
+    if (poziom == 0) {
+        ekran[(w - okno.w) * SZEROKOSC_EKRANU + (k - okno.k)] = ZYWA;
+        return;
+    }
+    Twezel n = h -> wezly[x];
+    long long pol = bok / 2;
+    hl_wypelnij(h, n.lg, poziom - 1, w, k, okno, ekran);
+    hl_wypelnij(h, n.pg, poziom - 1, w, k + pol, okno, ekran);
+    hl_wypelnij(h, n.ld, poziom - 1, w + pol, k, okno, ekran);
+    hl_wypelnij(h, n.pd, poziom - 1, w + pol, k + pol, okno, ekran);
+}
+
+/*  Wypisuje okno zadane przez 'okno' do bufora 'p' na podstawie drzewa
+    'h'.  */
+WEWNETRZNA void hl_wypisz_okno(Thashlife* h, Tpisarz* p, Tokno okno) {
+    hl_wypelnij(h, h -> korzen, h -> wezly[h -> korzen].poziom, 
+        h -> min_w, h -> min_k, okno, nowy_ekran(p));
+}
+
+/*  Dopisuje do zbioru 'zywe', każdą jako osobny wiersz, żywe komórki węzła
+    'x' drzewa 'h' o boku 2^poziom i lewym górnym rogu w wierszu 'w' 
+    i kolumnie 'k', które leżą w prostokącie 'r'. Węzły poza prostokątem
+    są pomijane w całości.  */
+WEWNETRZNA void hl_prostokat(Thashlife* h, uint32_t x, int poziom, long long w, 
+    long long k, Tprostokat r, Tzywe* zywe) {
+
+    long long bok = 1LL << poziom;
+    if (hl_czy_pusty(h, x) || w > r.w2 || k > r.k2 || w + bok <= r.w1 
+        || k + bok <= r.k1) {
+        return;
+    }
+    if (poziom == 0) {
+        int n = ile_zywych(zywe);
+        zarezerwuj(zywe, zywe -> ile_w + 1, n + 1);
+        zywe -> w[zywe -> ile_w] = (int) w;
+        zywe -> k[n] = (int) k;
+        zakoncz_wiersz(zywe, n + 1);
+        return;
+    }
+    Twezel n = h -> wezly[x];
+    long long pol = bok / 2;
+    hl_prostokat(h, n.lg, poziom - 1, w, k, r, zywe);
+    hl_prostokat(h, n.pg, poziom - 1, w, k + pol, r, zywe);
+    hl_prostokat(h, n.ld, poziom - 1, w + pol, k, r, zywe);
+    hl_prostokat(h, n.pd, poziom - 1, w + pol, k + pol, r, zywe);
+}
+
+/*  Wypisuje do bufora 'p' wiersze pasa o wysokości 2^poziom zaczynającego
+    się w wierszu 'w' albo, gdy 'zywe' nie jest NULL, dopisuje je na koniec
+    tego zbioru. Pas tworzy 'ile' niepustych węzłów leżących w tablicy
+    '*pas' od indeksu 'pocz', uporządkowanych od lewej do prawej. Dalsza 
+    część tablicy służy jako stos na pasy o mniejszej wysokości.  */
+WEWNETRZNA void hl_zrzut_pasa(Thashlife* h, Tpisarz* p, Tzywe* zywe, 
+    Tw_pasie** pas, size_t* poj, size_t pocz, size_t ile, int poziom, 
+    long long w) {
+
+    if (ile == 0) {
+        return;
+    }
+    if (poziom == 0 && zywe != NULL) {
+        int n = ile_zywych(zywe);
+        zarezerwuj(zywe, zywe -> ile_w + 1, n + (int) ile);
+        zywe -> w[zywe -> ile_w] = (int) w;
+        for (size_t i = pocz; i < pocz + ile; i++) {
+            zywe -> k[n++] = (int) (*pas)[i].k;
+        }
+        zakoncz_wiersz(zywe, n);
+        return;
+    }
+    if (poziom == 0) {
+        wypisz_liczbe(p, SLASH, w);
+        for (size_t i = pocz; i < pocz + ile; i++) {
+            wypisz_liczbe(p, SPACJA, (*pas)[i].k);
+        }
+        wypisz_znak(p, ENTER);
+        return;
+    }
+    if (pocz + 3 * ile > *poj) {
+        *poj = 2 * (pocz + 3 * ile);
+        *pas = (Tw_pasie*) realloc(*pas, *poj * sizeof(Tw_pasie));
+        assert(*pas != NULL);
+    }
+    long long pol = 1LL << (poziom - 1);
+    // Najpierw górne połówki węzłów, potem dolne.
+    for (int dolna = 0; dolna < 2; dolna++) {
+        size_t nowe = pocz + ile;
+        size_t n = nowe;
+        for (size_t i = pocz; i < pocz + ile; i++) {
+            Twezel x = h -> wezly[(*pas)[i].wezel];
+            uint32_t lewa = dolna ? x.ld : x.lg;
+            uint32_t prawa = dolna ? x.pd : x.pg;
+            if (!hl_czy_pusty(h, lewa)) {
+                (*pas)[n].wezel = lewa;
+                (*pas)[n++].k = (*pas)[i].k;
+            }
+            if (!hl_czy_pusty(h, prawa)) {
+                (*pas)[n].wezel = prawa;
+                (*pas)[n++].k = (*pas)[i].k + pol;
+            }
+        }
+        hl_zrzut_pasa(h, p, zywe, pas, poj, nowe, n - nowe, poziom - 1, 
+            w + dolna * pol);
+    }
+}
+
+/*  Wypisuje do bufora 'p' albo dopisuje do zbioru 'zywe' (gdy nie jest
+    NULL) wszystkie wiersze aktualnej generacji drzewa 'h'.  */
+WEWNETRZNA void hl_wiersze(Thashlife* h, Tpisarz* p, Tzywe* zywe) {
+    size_t poj = 64;
+    Tw_pasie* pas = (Tw_pasie*) malloc(poj * sizeof(Tw_pasie));
+    assert(pas != NULL);
+    size_t ile = 0;
+    if (!hl_czy_pusty(h, h -> korzen)) {
+        pas[0].wezel = h -> korzen;
+        pas[0].k = h -> min_k;
+        ile = 1;
+    }
+    hl_zrzut_pasa(h, p, zywe, &pas, &poj, 0, ile, 
+        h -> wezly[h -> korzen].poziom, h -> min_w);
+    free(pas);
+}
+
+/*  Wypisuje stan aktualnej generacji na podstawie drzewa 'h'.  */
+WEWNETRZNA void hl_zrzut(Thashlife* h, Tpisarz* p) {
+    hl_wiersze(h, p, NULL);
+    wypisz_znak(p, SLASH);
+    wypisz_znak(p, ENTER);
+}
+
+/*  Zapisuje w zbiorze 'zywe' aktualną generację drzewa 'h'.  */
+WEWNETRZNA void hl_zapisz(Thashlife* h, Tzywe* zywe) {
+    wyczysc_zywe(zywe);
+    hl_wiersze(h, NULL, zywe);
+}
+
+/*  Przekazuje liczbę żywych komórek węzła 'x' drzewa 'h'. Wyniki dla
+    węzłów trafiają do tablicy 'ile' powiększone o jeden, a zero oznacza
+    wynik jeszcze nieznany, więc każdy wspólny węzeł jest liczony raz.  */
+WEWNETRZNA uint64_t hl_zlicz(Thashlife* h, uint32_t x, uint64_t* ile) {
+    if (x <= 1) {
+        return x;
+    }
+    if (ile[x] == 0) {
+        Twezel* n = &(h -> wezly[x]);
+        ile[x] = 1 + hl_zlicz(h, n -> lg, ile) + hl_zlicz(h, n -> pg, ile)
+                 + hl_zlicz(h, n -> ld, ile) + hl_zlicz(h, n -> pd, ile);
+    }
+    return ile[x] - 1;
+}
+
+/*  Przekazuje liczbę żywych komórek drzewa 'h'.  */
+WEWNETRZNA long long hl_populacja(Thashlife* h) {
+    uint64_t* ile = (uint64_t*) calloc(h -> ile, sizeof(uint64_t));
+    assert(ile != NULL);
+    long long wynik = (long long) hl_zlicz(h, h -> korzen, ile);
+    free(ile);
+    return wynik;
+}
+
+/*  Przekazuje odległość od brzegu 'strona' (0 - górny, 1 - lewy, 2 - dolny,
+    3 - prawy) niepustego węzła 'x' drzewa 'h' do najbliższej mu żywej 
+    komórki. Schodzi tylko do ćwiartek przy tym brzegu, a do dalszych 
+    jedynie wtedy, gdy bliższe są puste. Wyniki trafiają do tablicy 'odl' 
+    jak w hl_zlicz, więc każdy wspólny węzeł jest liczony raz.  */
+WEWNETRZNA uint64_t hl_odleglosc(Thashlife* h, uint32_t x, int strona, 
+    uint64_t* odl) {
+
+    if (x <= 1) {
+        return 0;
+    }
+    if (odl[x] == 0) {
+        Twezel* n = &(h -> wezly[x]);
+        uint32_t cwiartki[4][4] = {
+            {n -> lg, n -> pg, n -> ld, n -> pd},
+            {n -> lg, n -> ld, n -> pg, n -> pd},
+            {n -> ld, n -> pd, n -> lg, n -> pg},
+            {n -> pg, n -> pd, n -> lg, n -> ld}
+        };
+        uint32_t* c = cwiartki[strona];
+        uint64_t pol = 0;
+        if (hl_czy_pusty(h, c[0]) && hl_czy_pusty(h, c[1])) {
+            c += 2;
+            pol = 1ULL << (n -> poziom - 1);
+        }
+        uint64_t wynik = UINT64_MAX;
+        for (int i = 0; i < 2; i++) {
+            if (!hl_czy_pusty(h, c[i])) {
+                uint64_t d = hl_odleglosc(h, c[i], strona, odl);
+                wynik = d < wynik ? d : wynik;
+            }
+        }
+        odl[x] = 1 + pol + wynik;
+    }
+    return odl[x] - 1;
+}
+
+/*  Zapisuje w '*wysokosc' i '*szerokosc' wymiary najmniejszego 
+    prostokąta zawierającego żywe komórki drzewa 'h' (zera dla pustego).  */
+WEWNETRZNA void hl_wymiary(Thashlife* h, long long* wysokosc, 
+    long long* szerokosc) {
+
+    *wysokosc = 0;
+    *szerokosc = 0;
+    if (hl_czy_pusty(h, h -> korzen)) {
+        return;
+    }
+    uint64_t* odl = (uint64_t*) malloc(h -> ile * sizeof(uint64_t));
+    assert(odl != NULL);
+    long long brzegi[4];
+    for (int strona = 0; strona < 4; strona++) {
+        memset(odl, 0, h -> ile * sizeof(uint64_t));
+        brzegi[strona] = (long long) hl_odleglosc(h, h -> korzen, strona, odl);
+    }
+    free(odl);
+    long long bok = 1LL << h -> wezly[h -> korzen].poziom;
+    *wysokosc = bok - brzegi[0] - brzegi[2];
+    *szerokosc = bok - brzegi[1] - brzegi[3];
+}
+
+/*  Inicjalizuje drzewo 'h' z pustym wzorem dla reguły 'regula'. Po 
+    przekroczeniu 'limit' węzłów tablica węzłów jest odśmiecana.  */
+WEWNETRZNA void inicjalizuj_hashlife(Thashlife* h, uint32_t limit, int regula) {
+    h -> poj = 1 << 16;
+    h -> limit = limit > h -> poj ? limit : h -> poj;
+    h -> wezly = (Twezel*) malloc((size_t) h -> poj * sizeof(Twezel));
+    assert(h -> wezly != NULL);
+    h -> kubelki = NULL;
+    h -> stos = NULL;
+    h -> ile_stos = 0;
+    h -> poj_stos = 0;
+    h -> wolne = BRAK;
+    h -> odsmiecania = 0;
+    // Węzły 0 i 1 to martwa i żywa komórka.
+    for (uint32_t x = 0; x < 2; x++) {
+        h -> wezly[x].poziom = 0;
+        h -> wezly[x].lg = h -> wezly[x].pg = BRAK;
+        h -> wezly[x].ld = h -> wezly[x].pd = BRAK;
+        h -> wezly[x].znacznik = 0;
+    }
+    h -> ile = 2;
+    h -> zajete = 2;
+    hl_przelicz_kubelki(h);
+    for (int i = 0; i <= MAKS_POZIOM; i++) {
+        h -> puste[i] = BRAK;
+    }
+    h -> puste[0] = 0;
+    // Tabela następnej generacji środka każdego kwadratu 4 x 4.
+    for (int x = 0; x < (1 << 16); x++) {
+        int wynik = 0;
+        for (int i = 0; i < 4; i++) {
+            int r = 1 + i / 2, c = 1 + i % 2;
+            int sasiedzi = 0;
+            for (int dr = -1; dr < 2; dr++) {
+                for (int dc = -1; dc < 2; dc++) {
+                    if (dr != 0 || dc != 0) {
+                        sasiedzi += (x >> (4 * (r + dr) + c + dc)) & 1;
+                    }
+                }
+            }
+            int zywa = (x >> (4 * r + c)) & 1;
+            if (wedlug_reguly(regula, zywa, sasiedzi)) {
+                wynik |= 1 << i;
+            }
+        }
+        h -> tabela[x] = (uint8_t) wynik;
+    }
+    h -> korzen = hl_pusty(h, 3);
+    h -> min_w = 0;
+    h -> min_k = 0;
+}
+
+/*  Zwalnia pamięć zarezerwowaną przez drzewo 'h'.  */
+WEWNETRZNA void zwolnij_hashlife(Thashlife* h) {
+    free(h -> wezly);
+    free(h -> kubelki);
+    free(h -> stos);
+}
+
+/*  Przekazuje czas zegara monotonicznego w sekundach.  */
+WEWNETRZNA double teraz(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec + (double) t.tv_nsec * 1e-9;
+}
+
+/*  Przekazuje czas zegara monotonicznego w nanosekundach.  */
+WEWNETRZNA long long zegar_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long) t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+/*  Przekazuje 1, jeśli symulacja 'sym' liczy generacje na planszy 
+    kafelków, a w przeciwnym przypadku 0.  */
+WEWNETRZNA int na_planszy(Tsymulacja* sym) {
+    return (sym -> silnik == SILNIK_LISTA 
+            || (sym -> silnik == SILNIK_AUTO && !sym -> tryb_bity))
+           && sym -> watki == 0 && sym -> procesy == 0;
+}
+
+/*  Zastępuje żywe komórki symulacji 'sym' komórkami z bufora 
+    'sym -> bufory.nast' i w razie potrzeby uaktualnia planszę.  */
+WEWNETRZNA void zastap_zywe(Tsymulacja* sym) {
+    if (na_planszy(sym)) {
+        POCZATEK_POMIARU(t);
+        ustaw(&(sym -> plansza), &(sym -> zywe_wiersze), MARTWA);
+        KONIEC_POMIARU(sym, FAZA_USTAW, t);
+        POCZATEK_POMIARU(u);
+        umiesc_zywe(&(sym -> plansza), &(sym -> bufory.nast));
+        KONIEC_POMIARU(sym, FAZA_UMIESC, u);
+    }
+    Tzywe temp = sym -> zywe_wiersze;
+    sym -> zywe_wiersze = sym -> bufory.nast;
+    sym -> bufory.nast = temp;
+}
+
+/*  Oblicza jedną generację silnikiem listowym symulacji 'sym'.  */
+WEWNETRZNA void krok_listy(Tsymulacja* sym) {
+    POCZATEK_POMIARU(t);
+    if (sym -> watki == 0) {
+        nowe_zywe(&(sym -> bufory), &(sym -> plansza), 
+            &(sym -> zywe_wiersze), sym -> regula);
+        KONIEC_POMIARU(sym, FAZA_NOWE_ZYWE, t);
+    }
+    else {
+        krok_pasmami(&(sym -> pula), &(sym -> zywe_wiersze), 
+            &(sym -> bufory.nast), sym -> regula);
+        KONIEC_POMIARU(sym, FAZA_PASMA, t);
+    }
+    zastap_zywe(sym);
+    sym -> cykl.pokolenie++;
+}
+
+/*  Dołącza do wykrywania cyklu 'c' bieżącą generację 'zywe'. Jej skrót 
+    trafia do historii. Gdy ten sam kształt, być może przesunięty, pojawia
+    się ponownie, generacja jest kopiowana, a po 'p' kolejnych generacjach
+    (gdzie 'p' to odstęp między wystąpieniami) porównywana z kopią. 
+    Sprawdzanie ciągnie się więc przez kolejne wywołania, także gdy 
+    generacje są liczone po jednej.  */
+WEWNETRZNA void sprawdz_cykl(Tcykl* c, Tzywe* zywe) {
+    if (c -> kandydat > 0) {
+        if (c -> pokolenie < c -> sprawdzenie) {
+            return;
+        }
+        if (rowne_z_przesunieciem(zywe, &(c -> kopia), c -> kandydat_dw, 
+                                  c -> kandydat_dk)) {
+            c -> okres = c -> kandydat;
+            c -> dw = c -> kandydat_dw;
+            c -> dk = c -> kandydat_dk;
+        }
+        c -> kandydat = 0;
+        return;
+    }
+    int w, k;
+    uint64_t skrot = skrot_zywych(zywe, &w, &k);
+    Twpis_historii* e = &(c -> historia[skrot & (ROZMIAR_HISTORII - 1)]);
+    if (e -> pokolenie >= 0 && e -> skrot == skrot 
+        && e -> zywych == ile_zywych(zywe) 
+        && c -> pokolenie - e -> pokolenie <= INT_MAX) {
+        // Kolejne generacje i tak trzeba policzyć, więc sprawdzenie 
+        // cyklu nic nie kosztuje.
+        c -> kandydat = (int) (c -> pokolenie - e -> pokolenie);
+        c -> kandydat_dw = w - e -> w;
+        c -> kandydat_dk = k - e -> k;
+        c -> sprawdzenie = c -> pokolenie + c -> kandydat;
+        kopiuj_zywe(zywe, &(c -> kopia));
+        return;
+    }
+    e -> skrot = skrot;
+    e -> pokolenie = c -> pokolenie;
+    e -> w = w;
+    e -> k = k;
+    e -> zywych = ile_zywych(zywe);
+}
+
+/*  Oblicza 'ile' kolejnych generacji silnikiem listowym symulacji 'sym'.
+    Po każdej generacji sprawdzane jest, czy wzór wpadł w cykl. Jeśli tak,
+    pozostałe generacje są pomijane całymi okresami przez przesunięcie 
+    komórek.  */
+WEWNETRZNA void generacje_listy(Tsymulacja* sym, long long ile) {
+    Tcykl* c = &(sym -> cykl);
+    Tzywe* zywe = &(sym -> zywe_wiersze);
+    while (ile > 0) {
+        if (c -> okres > 0 && ile >= c -> okres) {
+            long long q = ile / c -> okres;
+            if (na_planszy(sym)) {
+                ustaw(&(sym -> plansza), zywe, MARTWA);
+            }
+            przesun_zywe(zywe, q * c -> dw, q * c -> dk);
+            if (na_planszy(sym)) {
+                umiesc_zywe(&(sym -> plansza), zywe);
+            }
+            c -> pokolenie += q * c -> okres;
+            ile -= q * c -> okres;
+            continue;
+        }
+        krok_listy(sym);
+        ile--;
+        if (c -> okres == 0) {
+            sprawdz_cykl(c, zywe);
+        }
+    }
+}
+
+/*  Wypisuje do bufora 'p' okres i przesunięcie cyklu 'c' albo informację,
+    że cykl nie został wykryty.  */
+WEWNETRZNA void wypisz_okres(Tpisarz* p, Tcykl* c) {
+    if (c -> okres == 0) {
+        wypisz_tekst(p, "okres: nieznany");
+    }
+    else {
+        wypisz_tekst(p, "okres:");
+        wypisz_liczbe(p, SPACJA, c -> okres);
+        wypisz_tekst(p, ", przesunięcie:");
+        wypisz_liczbe(p, SPACJA, c -> dw);
+        wypisz_liczbe(p, SPACJA, c -> dk);
+    }
+    wypisz_znak(p, ENTER);
+}
+
+/*  Przekazuje pole prostokąta, który zbiór 'z' zająłby wraz z marginesami
+    na planszy bitowej, czyli przybliżony koszt generacji liczonej 
+    silnikiem bitowym.  */
+WEWNETRZNA long long pole_bitow_zywych(Tzywe* z) {
+    if (z -> ile_w == 0) {
+        return 0;
+    }
+    int lewa = INT_MAX, prawa = INT_MIN;
+    for (int i = 0; i < z -> ile_w; i++) {
+        lewa = z -> k[z -> pocz[i]] < lewa ? z -> k[z -> pocz[i]] : lewa;
+        prawa = z -> k[z -> pocz[i + 1] - 1] > prawa 
+                ? z -> k[z -> pocz[i + 1] - 1] : prawa;
+    }
+    return ((long long) z -> w[z -> ile_w - 1] - z -> w[0] + 1 
+            + 2 * MARGINES_BITOW)
+           * ((long long) prawa - lewa + 1 + 2 * MARGINES_BITOW);
+}
+
+/*  Przekazuje liczbę żywych komórek planszy bitowej 'p'.  */
+WEWNETRZNA long long ile_bitow_planszy(Tbity* p) {
+    long long ile = 0;
+    size_t rozmiar = (size_t) p -> wiersze * (size_t) p -> slowa;
+    for (size_t i = 0; i < rozmiar; i++) {
+        ile += ile_bitow(p -> akt[i]);
+    }
+    return ile;
+}
+
+/*  Przekazuje 1, jeśli przy 'zywe' żywych komórkach na polu 'pole' tryb
+    automatyczny powinien liczyć silnikiem bitowym, a 0, jeśli listowym.
+    Silnik, który właśnie liczy ('bity'), zostaje przy niższej gęstości niż
+    ta, przy której się go wybiera, aby wzór o gęstości bliskiej progowi
+    nie przełączał się co chwilę.  */
+WEWNETRZNA int gesty(long long zywe, long long pole, int bity) {
+    return zywe * (bity ? PROG_LISTY : PROG_BITOW) >= pole;
+}
+
+/*  Przełącza tryb automatyczny symulacji 'sym' na silnik bitowy (gdy 
+    'bity' jest niezerowe) albo listowy. Plansza znaków jest potrzebna 
+    tylko silnikowi listowemu, więc komórki są z niej zdejmowane albo na 
+    nią wracają.  */
+WEWNETRZNA void przelacz_tryb(Tsymulacja* sym, int bity) {
+    if (sym -> watki == 0 && bity) {
+        ustaw(&(sym -> plansza), &(sym -> zywe_wiersze), MARTWA);
+    }
+    else if (sym -> watki == 0) {
+        umiesc_zywe(&(sym -> plansza), &(sym -> zywe_wiersze));
+    }
+    // Skróty z jednego silnika są zapisywane co generację, a z drugiego
+    // co 'PORCJA_AUTO', więc nie wolno ich mieszać.
+    zapomnij_skroty(&(sym -> cykl));
+    sym -> tryb_bity = bity;
+    sym -> przelaczenia++;
+}
+
+/*  Sprawdza, czy generacja numer 'pokolenie' planszy bitowej 'p' symulacji
+    'sym' w trybie automatycznym, być może przesunięta, była już 
+    sprawdzana. Sprawdzane są tylko co 'PORCJA_AUTO' generacje, więc 
+    odstęp między powtórzeniami może być wielokrotnością okresu. Jeśli 
+    tak jest, symulacja przez dwa takie odstępy zostaje przy silniku 
+    listowym, który w tym czasie wykryje najkrótszy okres.  */
+WEWNETRZNA int powtorzone_bity(Tsymulacja* sym, Tbity* p, long long pokolenie) {
+    Tcykl* c = &(sym -> cykl);
+    Tzywe* zywe = &(sym -> bufory.nast);
+    zapisz_bity(p, zywe);
+    int w, k;
+    uint64_t skrot = skrot_zywych(zywe, &w, &k);
+    Twpis_historii* e = &(c -> historia[skrot & (ROZMIAR_HISTORII - 1)]);
+    if (e -> pokolenie >= 0 && e -> skrot == skrot 
+        && e -> zywych == ile_zywych(zywe)) {
+        c -> bez_bitow = pokolenie + 2 * (pokolenie - e -> pokolenie) 
+                         + PORCJA_AUTO;
+        return 1;
+    }
+    e -> skrot = skrot;
+    e -> pokolenie = pokolenie;
+    e -> w = w;
+    e -> k = k;
+    e -> zywych = ile_zywych(zywe);
+    return 0;
+}
+
+/*  Rozdziela bieżącą generację symulacji 'sym' między procesy robocze na
+    pasy o zbliżonej liczbie komórek, tak jak pasma wątków, i zwalnia ją 
+    w procesie głównym, któremu odtąd wystarczają stany pasów. Pierwszy 
+    i ostatni pas nie mają granicy od zewnątrz. Każdy pas ma co najmniej 
+    jeden wiersz, więc wiersz tuż za pasem zawsze należy do sąsiedniego 
+    procesu.  */
+WEWNETRZNA void rozdaj_pasy(Tsymulacja* sym) {
+    Tprocesy* r = &(sym -> robocze);
+    Tzywe* zywe = &(sym -> zywe_wiersze);
+    long long wszystkie = ile_zywych(zywe);
+    Tzlecenie z = nowe_zlecenie(ZLECENIE_PAS);
+    z.regula = sym -> regula;
+    z.od_w = INT_MIN + 1;
+    int od = 0; // Pierwszy wiersz zbioru należący do pasa.
+    for (int p = 0; p < r -> ile; p++) {
+        if (p == r -> ile - 1) {
+            z.do_w = INT_MAX - 1;
+        }
+        else if (zywe -> ile_w == 0) {
+            z.do_w = z.od_w + 1;
+        }
+        else {
+            int i = pierwszy_niemniejszy(zywe -> pocz, 0, zywe -> ile_w,
+                (int) (wszystkie * (p + 1) / r -> ile));
+            z.do_w = i < zywe -> ile_w ? zywe -> w[i] 
+                     : zywe -> w[zywe -> ile_w - 1] + 2;
+            z.do_w = z.do_w > z.od_w ? z.do_w : z.od_w + 1;
+        }
+        int i = pierwszy_niemniejszy(zywe -> w, od, zywe -> ile_w, z.do_w);
+        zlec(r, p, &z);
+        if (!wyslij_wiersze(r -> gniazda[p], zywe, od, i)) {
+            fprintf(stderr, "Proces roboczy nie odpowiada\n");
+            exit(1);
+        }
+        od = i;
+        z.od_w = z.do_w;
+    }
+    for (int p = 0; p < r -> ile; p++) {
+        odbierz_stan(r, p);
+    }
+    long long przydzialy = zywe -> przydzialy;
+    zwolnij_zywe(zywe);
+    inicjalizuj_zywe(zywe);
+    zywe -> przydzialy = przydzialy;
+}
+
+/*  Oblicza 'ile' kolejnych generacji symulacji 'sym' w procesach 
+    roboczych, które trzymają pasy między poleceniami. Po każdej porcji
+    'PORCJA_PROCESOW' generacji procesy odsyłają tylko stany pasów, na 
+    podstawie których granice pasów są przesuwane, więc pasy podążają za 
+    wzorem, gdy ten się przemieszcza lub rośnie.  */
+WEWNETRZNA void generacje_procesami(Tsymulacja* sym, long long ile) {
+    Tprocesy* r = &(sym -> robocze);
+    while (ile > 0 && zywe_procesow(r) > 0) {
+        POCZATEK_POMIARU(t);
+        wyrownaj_pasy(r);
+        Tzlecenie z = nowe_zlecenie(ZLECENIE_GENERACJE);
+        z.ile = ile < PORCJA_PROCESOW ? ile : PORCJA_PROCESOW;
+        for (int p = 0; p < r -> ile; p++) {
+            zlec(r, p, &z);
+        }
+        for (int p = 0; p < r -> ile; p++) {
+            odbierz_stan(r, p);
+        }
+        sym -> cykl.pokolenie += z.ile;
+        ile -= z.ile;
+        KONIEC_POMIARU(sym, FAZA_PASMA, t);
+    }
+    // Pusta płaszczyzna już się nie zmieni.
+    sym -> cykl.pokolenie += ile;
+}
+
+/*  Oblicza 'ile' kolejnych generacji symulacji 'sym' w trybie 
+    automatycznym. Rzadki wzór jest liczony silnikiem listowym po 
+    'PORCJA_AUTO' generacji, między którymi sprawdzana jest gęstość. Gęsty
+    wzór jest liczony silnikiem bitowym, który przechodzi bez rozgałęzień 
+    cały prostokąt z komórkami, dopóki gęstość (sprawdzana co 'PORCJA_AUTO'
+    generacji) nie spadnie albo generacja się nie powtórzy. Po wykryciu 
+    cyklu zostaje silnik listowy, bo pomija on całe okresy naraz.  */
+WEWNETRZNA void generacje_auto(Tsymulacja* sym, long long ile) {
+    Tzywe* zywe = &(sym -> zywe_wiersze);
+    Tcykl* c = &(sym -> cykl);
+    while (ile > 0) {
+        int bity = c -> okres == 0 && c -> pokolenie >= c -> bez_bitow
+            && gesty(ile_zywych(zywe), pole_bitow_zywych(zywe), 
+                     sym -> tryb_bity);
+        if (bity != sym -> tryb_bity) {
+            przelacz_tryb(sym, bity);
+        }
+        if (c -> okres > 0) {
+            // Cykl pomija wszystkie pozostałe generacje naraz.
+            generacje_listy(sym, ile);
+            return;
+        }
+        if (!bity) {
+            long long n = ile < PORCJA_AUTO ? ile : PORCJA_AUTO;
+            generacje_listy(sym, n);
+            ile -= n;
+            continue;
+        }
+        POCZATEK_POMIARU(t);
+        Tbity* p = &(sym -> bity);
+        zaladuj_bity(p, zywe);
+        long long zrobione = 0;
+        while (zrobione < ile && bity) {
+            krok_bity(p, sym -> regula);
+            zrobione++;
+            if (zrobione % PORCJA_AUTO == 0) {
+                bity = gesty(ile_bitow_planszy(p), 
+                    64 * (long long) p -> wiersze * (p -> slowa - 2), 1)
+                    && !powtorzone_bity(sym, p, c -> pokolenie + zrobione);
+            }
+        }
+        zapisz_bity(p, &(sym -> bufory.nast));
+        zwolnij_bity(p);
+        zastap_zywe(sym);
+        sym -> cykl.pokolenie += zrobione;
+        ile -= zrobione;
+        KONIEC_POMIARU(sym, FAZA_BITY, t);
+    }
+}
+
+/*  Oblicza 'ile' kolejnych generacji silnikiem wybranym w symulacji 'sym'.  */
+WEWNETRZNA void generacje_silnika(Tsymulacja* sym, long long ile) {
+    POCZATEK_POMIARU(t);
+    switch (sym -> silnik) {
+        case SILNIK_LISTA:
+            if (sym -> procesy > 0) {
+                generacje_procesami(sym, ile);
+            }
+            else {
+                generacje_listy(sym, ile);
+            }
+            break;
+        case SILNIK_BITY:
+            zaladuj_bity(&(sym -> bity), &(sym -> zywe_wiersze));
+            for (long long i = 0; i < ile; i++) {
+                krok_bity(&(sym -> bity), sym -> regula);
+            }
+            zapisz_bity(&(sym -> bity), &(sym -> bufory.nast));
+            if (sym -> bity.wysokosc == 0) {
+                // Plansza o stałych wymiarach zostaje na kolejne kroki.
+                zwolnij_bity(&(sym -> bity));
+            }
+            zastap_zywe(sym);
+            sym -> cykl.pokolenie += ile;
+            KONIEC_POMIARU(sym, FAZA_BITY, t);
+            break;
+        case SILNIK_HASHLIFE:
+            hl_generacje(&(sym -> hl), ile);
+            sym -> cykl.pokolenie += ile;
+            KONIEC_POMIARU(sym, FAZA_HASHLIFE, t);
+            break;
+        case SILNIK_OBSZARY:
+            for (long long i = 0; i < ile; i++) {
+                krok_obszarow(&(sym -> obszary), sym -> regula);
+            }
+            zapisz_obszary(&(sym -> obszary), &(sym -> bufory.nast));
+            zastap_zywe(sym);
+            sym -> cykl.pokolenie += ile;
+            KONIEC_POMIARU(sym, FAZA_OBSZARY, t);
+            break;
+        case SILNIK_AUTO:
+            generacje_auto(sym, ile);
+            break;
+        default: assert(0); // Błąd.
+    }
+}
+
+/*  Przekazuje liczbę żywych komórek bieżącej generacji symulacji 'sym'.  */
+WEWNETRZNA long long populacja(Tsymulacja* sym) {
+    if (sym -> silnik == SILNIK_HASHLIFE) {
+        return hl_populacja(&(sym -> hl));
+    }
+    if (sym -> procesy > 0) {
+        return zywe_procesow(&(sym -> robocze));
+    }
+    return ile_zywych(&(sym -> zywe_wiersze));
+}
+
+/*  Przekazuje liczbę przydziałów pamięci na żywe komórki symulacji 
+    'sym'.  */
+WEWNETRZNA long long przydzialy_zywych(Tsymulacja* sym) {
+    return sym -> zywe_wiersze.przydzialy + sym -> bufory.gora.przydzialy 
+           + sym -> bufory.srodek.przydzialy + sym -> bufory.dol.przydzialy 
+           + sym -> bufory.nast.przydzialy;
+}
+
+/*  Wypisuje do bufora symulacji 'sym' wszystkie żywe komórki bieżącej 
+    generacji.  */
+WEWNETRZNA void zrzut_symulacji(Tsymulacja* sym) {
+    POCZATEK_POMIARU(t);
+    if (sym -> silnik == SILNIK_HASHLIFE) {
+        hl_zrzut(&(sym -> hl), &(sym -> pisarz));
+    }
+    else if (sym -> procesy > 0) {
+        // Pasy są pobierane i wypisywane po jednym.
+        Tprostokat calosc = {INT_MIN, INT_MIN, INT_MAX, INT_MAX};
+        for (int p = 0; p < sym -> robocze.ile; p++) {
+            wyczysc_zywe(&(sym -> bufory.nast));
+            pobierz_pas(&(sym -> robocze), p, calosc, &(sym -> bufory.nast));
+            wypisz_wiersze(&(sym -> pisarz), &(sym -> bufory.nast));
+        }
+        wypisz_znak(&(sym -> pisarz), SLASH);
+        wypisz_znak(&(sym -> pisarz), ENTER);
+    }
+    else {
+        zrzut(&(sym -> pisarz), &(sym -> zywe_wiersze));
+    }
+    KONIEC_POMIARU(sym, FAZA_ZRZUT, t);
+}
+
+/*  Wypisuje do bufora symulacji 'sym' bieżące okno.  */
+WEWNETRZNA void wypisz_widok(Tsymulacja* sym) {
+    POCZATEK_POMIARU(t);
+    if (sym -> silnik == SILNIK_HASHLIFE) {
+        hl_wypisz_okno(&(sym -> hl), &(sym -> pisarz), sym -> okno);
+    }
+    else if (sym -> procesy > 0) {
+        // Komórki okna przychodzą tylko od procesów, których pasy je mają.
+        Tokno o = sym -> okno;
+        long long dol = (long long) o.w + WIERSZE - 1;
+        long long prawa = (long long) o.k + KOLUMNY - 1;
+        Tprostokat r = {o.w, o.k, dol < INT_MAX ? (int) dol : INT_MAX, 
+                        prawa < INT_MAX ? (int) prawa : INT_MAX};
+        Tzywe* z = &(sym -> bufory.nast);
+        wyczysc_zywe(z);
+        for (int p = 0; p < sym -> robocze.ile; p++) {
+            Tstan_pasa* s = &(sym -> robocze.pasy[p]);
+            if (s -> od_w <= r.w2 && s -> do_w > r.w1) {
+                pobierz_pas(&(sym -> robocze), p, r, z);
+            }
+        }
+        wypisz_okno(&(sym -> pisarz), z, o);
+    }
+    else {
+        wypisz_okno(&(sym -> pisarz), &(sym -> zywe_wiersze), sym -> okno);
+    }
+    KONIEC_POMIARU(sym, FAZA_OKNO, t);
+}
+
+/*  Przekazuje liczbę 'x' zapisaną bez znaku tak, aby liczby o małej 
+    wartości bezwzględnej pozostały małe: 0, -1, 1, -2, ... przechodzą na
+    0, 1, 2, 3, ...  */
+WEWNETRZNA uint64_t zygzak(long long x) {
+    return ((uint64_t) x << 1) ^ (x < 0 ? UINT64_MAX : 0);
+}
+
+/*  Przekazuje liczbę 'x' zapisaną przez funkcję 'zygzak'.  */
+WEWNETRZNA long long odwrotny_zygzak(uint64_t x) {
+    return (long long) (x >> 1) ^ -(long long) (x & 1);
+}
+
+/*  Przekazuje liczbę bajtów, które zajmuje liczba 'x' zapisana funkcją
+    'wypisz_varint'.  */
+WEWNETRZNA int dlugosc_varint(uint64_t x) {
+    int n = 1;
+    while (x >= 0x80) {
+        x >>= 7;
+        n++;
+    }
+    return n;
+}
+
+/*  Dopisuje do bufora 'p' liczbę 'x' po 7 bitów w bajcie, od najmłodszych.
+    Najstarszy bit jest ustawiony we wszystkich bajtach poza ostatnim.  */
+WEWNETRZNA void wypisz_varint(Tpisarz* p, uint64_t x) {
+    char* b = miejsce_w_buforze(p, 10);
+    size_t n = 0;
+    while (x >= 0x80) {
+        b[n++] = (char) (x | 0x80);
+        x >>= 7;
+    }
+    b[n++] = (char) x;
+    dopisane(p, n);
+}
+
+/*  Dopisuje do bufora 'p' najmłodsze 'bajty' bajtów liczby 'x', od 
+    najmłodszego.  */
+WEWNETRZNA void wypisz_slowo(Tpisarz* p, uint64_t x, int bajty) {
+    char* b = miejsce_w_buforze(p, (size_t) bajty);
+    for (int i = 0; i < bajty; i++) {
+        b[i] = (char) (x >> (8 * i));
+    }
+    dopisane(p, (size_t) bajty);
+}
+
+/*  Przekazuje liczbę zapisaną funkcją 'wypisz_slowo' na 'bajty' bajtach 
+    od miejsca 'b'.  */
+WEWNETRZNA uint64_t odczytaj_slowo(const char* b, int bajty) {
+    uint64_t x = 0;
+    for (int i = 0; i < bajty; i++) {
+        x |= (uint64_t) (unsigned char) b[i] << (8 * i);
+    }
+    return x;
+}
+
+/*  Wczytuje z czytnika 'c', który ma w buforze całą zawartość pliku, 
+    liczbę zapisaną funkcją 'wypisz_varint' do '*x'. Przekazuje 0, jeśli
+    zapis jest ucięty lub za długi, a w przeciwnym przypadku 1.  */
+WEWNETRZNA int wczytaj_varint(Tczytnik* c, uint64_t* x) {
+    uint64_t wynik = 0;
+    for (int przesuniecie = 0; przesuniecie < 64; przesuniecie += 7) {
+        if (c -> poz == c -> ile) {
+            return 0;
+        }
+        unsigned char b = (unsigned char) c -> bufor[c -> poz++];
+        wynik |= (uint64_t) (b & 0x7F) << przesuniecie;
+        if (b < 0x80) {
+            *x = wynik;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*  Dopisuje do bufora 'p' wiersz 'i' zbioru 'z' w postaci używanej 
+    w migawkach: zmianę numeru wiersza względem 'poprz_w', podwojoną 
+    liczbę komórek, której ostatni bit mówi, czy kolumny zapisano jako mapę
+    bitową, i zmianę pierwszej kolumny względem 'poprz_k'. Dalej są albo
+    odstępy między kolejnymi kolumnami pomniejszone o jeden, albo odległość
+    ostatniej kolumny od pierwszej i mapa bitowa kolumn od pierwszej do 
+    ostatniej. Wybierany jest krótszy z tych zapisów, więc gęste wiersze
+    zajmują co najwyżej bit na komórkę.  */
+WEWNETRZNA void wypisz_wiersz_migawki(Tpisarz* p, Tzywe* z, int i, int poprz_w, 
+    int poprz_k) {
+
+    int pocz = z -> pocz[i];
+    int ile = z -> pocz[i + 1] - pocz;
+    const int* k = z -> k + pocz;
+    long long lista = 0;
+    for (int j = 1; j < ile; j++) {
+        lista += dlugosc_varint((uint64_t) ((long long) k[j] - k[j - 1] - 1));
+    }
+    uint64_t rozpietosc = (uint64_t) ((long long) k[ile - 1] - k[0]);
+    long long bajty = (long long) (rozpietosc / 8 + 1);
+    int mapa = bajty + dlugosc_varint(rozpietosc) < lista;
+    wypisz_varint(p, zygzak((long long) z -> w[i] - poprz_w));
+    wypisz_varint(p, 2 * (uint64_t) ile + (uint64_t) mapa);
+    wypisz_varint(p, zygzak((long long) k[0] - poprz_k));
+    if (!mapa) {
+        for (int j = 1; j < ile; j++) {
+            wypisz_varint(p, (uint64_t) ((long long) k[j] - k[j - 1] - 1));
+        }
+        return;
+    }
+    wypisz_varint(p, rozpietosc);
+    unsigned char* b = (unsigned char*) miejsce_w_buforze(p, (size_t) bajty);
+    memset(b, 0, (size_t) bajty);
+    for (int j = 0; j < ile; j++) {
+        long long x = (long long) k[j] - k[0];
+        b[x / 8] |= (unsigned char) (1 << (x % 8));
+    }
+    dopisane(p, (size_t) bajty);
+}
+
+/*  Zapisuje do pliku o nazwie 'nazwa' migawkę symulacji 'sym'. Po 
+    nagłówku, w którym leżą znaczek, wersja formatu, reguła, numer 
+    generacji, okno oraz liczby wierszy i komórek (liczby o stałej 
+    długości, od najmłodszego bajtu), następują kolejne wiersze zapisane
+    funkcją 'wypisz_wiersz_migawki'. Przekazuje 0, jeśli pliku nie udało
+    się zapisać, a w przeciwnym przypadku 1.  */
+WEWNETRZNA int zapisz_migawke(Tsymulacja* sym, const char* nazwa) {
+    FILE* plik = fopen(nazwa, "wb");
+    if (plik == NULL) {
+        return 0;
+    }
+    Tzywe* z = &(sym -> zywe_wiersze);
+    if (sym -> silnik == SILNIK_HASHLIFE) {
+        z = &(sym -> bufory.nast);
+        hl_zapisz(&(sym -> hl), z);
+    }
+    long long wiersze = z -> ile_w, komorki = ile_zywych(z);
+    Tprocesy* r = &(sym -> robocze);
+    if (sym -> procesy > 0) {
+        // Pasy są pobierane i zapisywane po jednym.
+        z = &(sym -> bufory.nast);
+        wiersze = 0;
+        for (int t = 0; t < r -> ile; t++) {
+            wiersze += r -> pasy[t].wiersze;
+        }
+        komorki = zywe_procesow(r);
+    }
+    Tpisarz p;
+    inicjalizuj_pisarza(&p, plik);
+    wypisz_tekst(&p, ZNACZEK_MIGAWKI);
+    wypisz_slowo(&p, WERSJA_MIGAWKI, 4);
+    wypisz_slowo(&p, (uint64_t) sym -> regula, 4);
+    wypisz_slowo(&p, (uint64_t) sym -> cykl.pokolenie, 8);
+    wypisz_slowo(&p, (uint32_t) sym -> okno.w, 4);
+    wypisz_slowo(&p, (uint32_t) sym -> okno.k, 4);
+    wypisz_slowo(&p, (uint64_t) wiersze, 8);
+    wypisz_slowo(&p, (uint64_t) komorki, 8);
+    int poprz_w = 0, poprz_k = 0;
+    for (int t = 0; t < (sym -> procesy > 0 ? r -> ile : 1); t++) {
+        if (sym -> procesy > 0) {
+            Tprostokat calosc = {INT_MIN, INT_MIN, INT_MAX, INT_MAX};
+            wyczysc_zywe(z);
+            pobierz_pas(r, t, calosc, z);
+        }
+        for (int i = 0; i < z -> ile_w; i++) {
+            wypisz_wiersz_migawki(&p, z, i, poprz_w, poprz_k);
+            poprz_w = z -> w[i];
+            poprz_k = z -> k[z -> pocz[i]];
+        }
+    }
+    zwolnij_pisarza(&p);
+    int blad = ferror(plik);
+    return fclose(plik) == 0 && !blad;
+}
+
+/*  Wczytuje z czytnika 'c' 'wiersze' wierszy migawki zawierających razem
+    'komorki' komórek do pustego zbioru 'z', który ma już na nie miejsce. 
+    Przekazuje 0, jeśli zapis jest niepoprawny, a w przeciwnym 
+    przypadku 1.  */
+WEWNETRZNA int wczytaj_wiersze_migawki(Tczytnik* c, Tzywe* z, int wiersze, 
+    int komorki) {
+
+    long long w = 0, k = 0;
+    int n = 0; // Liczba wczytanych kolumn.
+    // Zmiana numeru wiersza lub kolumny między liczbami typu int może 
+    // wynosić blisko 2^32, więc po zapisie bez znaku ma do 33 bitów.
+    const uint64_t maks_zmiana = 2 * (uint64_t) UINT32_MAX;
+    for (int i = 0; i < wiersze; i++) {
+        uint64_t dw, ile, dk;
+        if (!wczytaj_varint(c, &dw) || !wczytaj_varint(c, &ile) 
+            || !wczytaj_varint(c, &dk) || dw > maks_zmiana || dk > maks_zmiana
+            || ile / 2 == 0 || ile / 2 > (uint64_t) (komorki - n)) {
+            return 0;
+        }
+        w += odwrotny_zygzak(dw);
+        k += odwrotny_zygzak(dk);
+        if (w < INT_MIN || w > INT_MAX || k < INT_MIN || k > INT_MAX
+            || (i > 0 && w <= z -> w[i - 1])) {
+            return 0;
+        }
+        int koniec = n + (int) (ile / 2);
+        z -> w[i] = (int) w;
+        if (ile % 2 == 0) {
+            long long kolumna = k;
+            z -> k[n++] = (int) kolumna;
+            while (n < koniec) {
+                uint64_t odstep;
+                if (!wczytaj_varint(c, &odstep) || odstep >= UINT32_MAX) {
+                    return 0;
+                }
+                kolumna += (long long) odstep + 1;
+                if (kolumna > INT_MAX) {
+                    return 0;
+                }
+                z -> k[n++] = (int) kolumna;
+            }
+        }
+        else {
+            uint64_t rozpietosc;
+            if (!wczytaj_varint(c, &rozpietosc) || rozpietosc > UINT32_MAX
+                || k + (long long) rozpietosc > INT_MAX
+                || c -> ile - c -> poz < rozpietosc / 8 + 1
+                || !(c -> bufor[c -> poz] & 1)
+                || ((unsigned char) c -> bufor[c -> poz + rozpietosc / 8] 
+                    >> (rozpietosc % 8 + 1)) != 0) {
+                return 0;
+            }
+            const unsigned char* b = (const unsigned char*) c -> bufor 
+                                     + c -> poz;
+            for (uint64_t j = 0; j <= rozpietosc / 8; j++) {
+                for (uint64_t x = b[j]; x != 0; x &= x - 1) {
+                    if (n == koniec) {
+                        return 0;
+                    }
+                    z -> k[n++] = (int) (k + 8 * (long long) j 
+                                         + najnizszy_bit(x));
+                }
+            }
+            if (n != koniec) {
+                return 0;
+            }
+            c -> poz += rozpietosc / 8 + 1;
+        }
+        zakoncz_wiersz(z, n);
+    }
+    return n == komorki && c -> poz == c -> ile;
+}
+
+/*  Zastępuje bieżącą generację symulacji 'sym' komórkami z bufora 
+    'sym -> bufory.nast' i przekazuje je silnikowi. Licznik generacji 
+    i historia cyklu są zerowane, a historia generacji zostaje bez 
+    zmian.  */
+WEWNETRZNA void wstaw_generacje(Tsymulacja* sym) {
+    zastap_zywe(sym);
+    wyczysc_cykl(&(sym -> cykl));
+    if (sym -> silnik == SILNIK_HASHLIFE) {
+        hl_zaladuj(&(sym -> hl), &(sym -> zywe_wiersze));
+    }
+    else if (sym -> silnik == SILNIK_OBSZARY) {
+        zaladuj_obszary(&(sym -> obszary), &(sym -> zywe_wiersze));
+    }
+    else if (sym -> procesy > 0) {
+        rozdaj_pasy(sym);
+    }
+}
+
+/*  Wypisuje do bufora 'p' wiersz 'w' ze znakiem 'znak' na początku 
+    i kolumnami z 'nb' rosnących kolumn 'b', których nie ma wśród 'na' 
+    rosnących kolumn 'a'. Nic nie wypisuje, jeśli takich kolumn nie ma.  */
+WEWNETRZNA void wypisz_roznice(Tpisarz* p, char znak, int w, int* a, int na, 
+    int* b, int nb) {
+
+    int i = 0;
+    int pierwsza = 1;
+    for (int j = 0; j < nb; j++) {
+        while (i < na && a[i] < b[j]) {
+            i++;
+        }
+        if (i < na && a[i] == b[j]) {
+            continue;
+        }
+        if (pierwsza) {
+            wypisz_liczbe(p, znak, w);
+            pierwsza = 0;
+        }
+        wypisz_liczbe(p, SPACJA, b[j]);
+    }
+    if (!pierwsza) {
+        wypisz_znak(p, ENTER);
+    }
+}
+
+/*  Przekazuje zbiór żywych komórek bieżącej generacji symulacji 'sym'. 
+    Silnik HashLife zapisuje je w tym celu do bufora 'sym -> bufory.nast',
+    a przy liczeniu w procesach trafiają tam pasy wszystkich procesów.  */
+WEWNETRZNA Tzywe* biezace_zywe(Tsymulacja* sym) {
+    if (sym -> silnik == SILNIK_HASHLIFE) {
+        hl_zapisz(&(sym -> hl), &(sym -> bufory.nast));
+        return &(sym -> bufory.nast);
+    }
+    if (sym -> procesy > 0) {
+        zbierz_pasy(&(sym -> robocze), &(sym -> bufory.nast));
+        return &(sym -> bufory.nast);
+    }
+    return &(sym -> zywe_wiersze);
+}
+
+/*  Zapisuje w strumieniu zmian 'm' numer generacji 'pokolenie' i, wiersz
+    po wierszu, komórki, które narodziły się ('+') i umarły ('-') od 
+    poprzedniego zapisu, mając jej żywe komórki 'b'. Koszt scalenia obu 
+    generacji jest liniowy, a długość zapisu zależy tylko od liczby 
+    zmian.  */
+WEWNETRZNA void zapisz_zmiany(Tzmiany* m, Tzywe* b, long long pokolenie) {
+    Tzywe* a = &(m -> poprzednia);
+    Tpisarz* p = &(m -> pisarz);
+    wypisz_liczbe(p, '@', pokolenie);
+    wypisz_znak(p, ENTER);
+    int i = 0, j = 0;
+    while (i < a -> ile_w || j < b -> ile_w) {
+        if (j == b -> ile_w || (i < a -> ile_w && a -> w[i] < b -> w[j])) {
+            wypisz_roznice(p, '-', a -> w[i], NULL, 0, 
+                a -> k + a -> pocz[i], a -> pocz[i + 1] - a -> pocz[i]);
+            i++;
+        }
+        else if (i == a -> ile_w || b -> w[j] < a -> w[i]) {
+            wypisz_roznice(p, '+', b -> w[j], NULL, 0, 
+                b -> k + b -> pocz[j], b -> pocz[j + 1] - b -> pocz[j]);
+            j++;
+        }
+        else {
+            int* ka = a -> k + a -> pocz[i];
+            int na = a -> pocz[i + 1] - a -> pocz[i];
+            int* kb = b -> k + b -> pocz[j];
+            int nb = b -> pocz[j + 1] - b -> pocz[j];
+            wypisz_roznice(p, '+', b -> w[j], ka, na, kb, nb);
+            wypisz_roznice(p, '-', a -> w[i], kb, nb, ka, na);
+            i++;
+            j++;
+        }
+    }
+    kopiuj_zywe(b, a);
+}
+
+/*  Inicjalizuje pustą historię 'h' z limitem pamięci 'limit' bajtów (0 
+    oznacza brak historii).  */
+WEWNETRZNA void inicjalizuj_historie(Thistoria* h, size_t limit) {
+    h -> limit = limit;
+    h -> bajty = 0;
+    h -> zapisy = NULL;
+    h -> ile = 0;
+    h -> poj = 0;
+    h -> klatka = 0;
+    h -> od_klatki = 0;
+    h -> zmiany = 0;
+    inicjalizuj_zywe(&(h -> poprzednia));
+    inicjalizuj_zywe(&(h -> roznica));
+    inicjalizuj_zywe(&(h -> suma));
+    inicjalizuj_pisarza(&(h -> pisarz), NULL);
+}
+
+/*  Zapomina zapisy historii 'h' od numeru 'od'.  */
+WEWNETRZNA void utnij_historie(Thistoria* h, int od) {
+    for (int i = od; i < h -> ile; i++) {
+        h -> bajty -= h -> zapisy[i].dlugosc + sizeof(Tzapis_historii);
+        free(h -> zapisy[i].dane);
+    }
+    h -> ile = od < h -> ile ? od : h -> ile;
+}
+
+/*  Zapomina wszystkie generacje zapamiętane w historii 'h'.  */
+WEWNETRZNA void wyczysc_historie(Thistoria* h) {
+    utnij_historie(h, 0);
+}
+
+/*  Zwalnia pamięć zarezerwowaną przez historię 'h'.  */
+WEWNETRZNA void zwolnij_historie(Thistoria* h) {
+    wyczysc_historie(h);
+    free(h -> zapisy);
+    zwolnij_zywe(&(h -> poprzednia));
+    zwolnij_zywe(&(h -> roznica));
+    zwolnij_zywe(&(h -> suma));
+    zwolnij_pisarza(&(h -> pisarz));
+}
+
+/*  Zapisuje w zbiorze 'wynik' komórki należące do dokładnie jednego ze 
+    zbiorów 'a' i 'b'. Różnica symetryczna dwóch generacji to komórki, 
+    które zmieniły stan, a różnica symetryczna generacji i tych komórek to
+    druga generacja.  */
+WEWNETRZNA void roznica_symetryczna(Tzywe* a, Tzywe* b, Tzywe* wynik) {
+    wyczysc_zywe(wynik);
+    zarezerwuj(wynik, a -> ile_w + b -> ile_w, ile_zywych(a) + ile_zywych(b));
+    int n = 0; // Liczba zapisanych kolumn.
+    int i = 0, j = 0;
+    while (i < a -> ile_w || j < b -> ile_w) {
+        // Kolumny bieżącego wiersza: 'a -> k[x]' do 'a -> k[kx - 1]' 
+        // i 'b -> k[y]' do 'b -> k[ky - 1]'.
+        int x = 0, kx = 0, y = 0, ky = 0;
+        int w;
+        if (j == b -> ile_w || (i < a -> ile_w && a -> w[i] < b -> w[j])) {
+            w = a -> w[i];
+            x = a -> pocz[i];
+            kx = a -> pocz[++i];
+        }
+        else if (i == a -> ile_w || b -> w[j] < a -> w[i]) {
+            w = b -> w[j];
+            y = b -> pocz[j];
+            ky = b -> pocz[++j];
+        }
+        else {
+            w = a -> w[i];
+            x = a -> pocz[i];
+            kx = a -> pocz[++i];
+            y = b -> pocz[j];
+            ky = b -> pocz[++j];
+        }
+        wynik -> w[wynik -> ile_w] = w;
+        while (x < kx || y < ky) {
+            if (y == ky || (x < kx && a -> k[x] < b -> k[y])) {
+                wynik -> k[n++] = a -> k[x++];
+            }
+            else if (x == kx || b -> k[y] < a -> k[x]) {
+                wynik -> k[n++] = b -> k[y++];
+            }
+            else {
+                x++;
+                y++;
+            }
+        }
+        zakoncz_wiersz(wynik, n);
+    }
+}
+
+/*  Dopisuje do historii 'h' zapis generacji 'pokolenie', którym jest cały
+    zbiór 'z', gdy 'klatka' jest niezerowe, a w przeciwnym przypadku 
+    komórki 'z', które zmieniły stan.  */
+WEWNETRZNA void dopisz_do_historii(Thistoria* h, long long pokolenie, Tzywe* z, 
+    int klatka) {
+
+    Tpisarz* p = &(h -> pisarz);
+    p -> ile = 0;
+    wypisz_slowo(p, (uint64_t) z -> ile_w, 4);
+    wypisz_slowo(p, (uint64_t) ile_zywych(z), 4);
+    for (int i = 0; i < z -> ile_w; i++) {
+        wypisz_wiersz_migawki(p, z, i, i > 0 ? z -> w[i - 1] : 0,
+            i > 0 ? z -> k[z -> pocz[i - 1]] : 0);
+    }
+    if (h -> ile == h -> poj) {
+        h -> poj = h -> poj > 0 ? 2 * h -> poj : 64;
+        h -> zapisy = (Tzapis_historii*) realloc(h -> zapisy, 
+            (size_t) h -> poj * sizeof(Tzapis_historii));
+        assert(h -> zapisy != NULL);
+    }
+    Tzapis_historii* zapis = &(h -> zapisy[h -> ile++]);
+    zapis -> pokolenie = pokolenie;
+    zapis -> klatka = klatka;
+    zapis -> dlugosc = p -> ile;
+    zapis -> dane = (char*) malloc(p -> ile);
+    assert(zapis -> dane != NULL);
+    memcpy(zapis -> dane, p -> bufor, p -> ile);
+    h -> bajty += p -> ile + sizeof(Tzapis_historii);
+    if (klatka) {
+        h -> klatka = p -> ile;
+        h -> od_klatki = 0;
+        h -> zmiany = 0;
+    }
+    else {
+        h -> od_klatki += p -> ile;
+        h -> zmiany++;
+    }
+}
+
+/*  Odczytuje do zbioru 'z' komórki z zapisu historii 'zapis'. Zapis 
+    powstał w 'dopisz_do_historii' tym samym koderem co migawki, a dekoder
+    przyjmuje wszystko, co koder może zapisać (także wiersze odległe 
+    o ponad 2^31), więc niepowodzenie oznacza błąd w programie.  */
+WEWNETRZNA void odczytaj_z_historii(Tzapis_historii* zapis, Tzywe* z) {
+    Tczytnik c;
+    c.bufor = zapis -> dane;
+    c.poz = 8;
+    c.ile = zapis -> dlugosc;
+    c.poj = zapis -> dlugosc;
+    c.plik = -1;
+    c.odwzorowany = 0;
+    int wiersze = (int) odczytaj_slowo(zapis -> dane, 4);
+    int komorki = (int) odczytaj_slowo(zapis -> dane + 4, 4);
+    wyczysc_zywe(z);
+    zarezerwuj(z, wiersze, komorki);
+    int poprawny = wczytaj_wiersze_migawki(&c, z, wiersze, komorki);
+    assert(poprawny);
+    (void) poprawny;
+}
+
+/*  Zapomina najstarszą klatkę historii 'h' razem z jej zmianami. 
+    Przekazuje 0, jeśli nie ma po niej innej klatki (wtedy nic nie jest 
+    zapominane), a w przeciwnym przypadku 1.  */
+WEWNETRZNA int zapomnij_klatke(Thistoria* h) {
+    int j = 1;
+    while (j < h -> ile && !h -> zapisy[j].klatka) {
+        j++;
+    }
+    if (j >= h -> ile) {
+        return 0;
+    }
+    for (int i = 0; i < j; i++) {
+        h -> bajty -= h -> zapisy[i].dlugosc + sizeof(Tzapis_historii);
+        free(h -> zapisy[i].dane);
+    }
+    memmove(h -> zapisy, h -> zapisy + j, 
+        (size_t) (h -> ile - j) * sizeof(Tzapis_historii));
+    h -> ile -= j;
+    return 1;
+}
+
+/*  Zapamiętuje w historii 'h' generację 'pokolenie' o żywych komórkach 
+    'z', następną po ostatnio zapamiętanej.  */
+WEWNETRZNA void zapamietaj_generacje(Thistoria* h, long long pokolenie, 
+    Tzywe* z) {
+
+    if (h -> ile == 0 || h -> zmiany >= MAKS_ZMIAN_HISTORII 
+        || h -> od_klatki >= h -> klatka || h -> bajty > h -> limit) {
+        dopisz_do_historii(h, pokolenie, z, 1);
+    }
+    else {
+        roznica_symetryczna(&(h -> poprzednia), z, &(h -> roznica));
+        dopisz_do_historii(h, pokolenie, &(h -> roznica), 0);
+    }
+    kopiuj_zywe(z, &(h -> poprzednia));
+    while (h -> bajty > h -> limit && zapomnij_klatke(h)) {
+    }
+}
+
+/*  Przywraca w symulacji 'sym' generację 'pokolenie' z historii 
+    i zapomina generacje późniejsze. Zmiany od najbliższej wcześniejszej 
+    klatki są najpierw składane ze sobą, a potem nakładane na klatkę 
+    jednym przejściem. Przekazuje 0, jeśli tej generacji nie ma 
+    w historii, a w przeciwnym przypadku 1.  */
+WEWNETRZNA int cofnij(Tsymulacja* sym, long long pokolenie) {
+    Thistoria* h = &(sym -> historia);
+    if (h -> ile == 0 || pokolenie < h -> zapisy[0].pokolenie 
+        || pokolenie > h -> zapisy[h -> ile - 1].pokolenie) {
+        return 0;
+    }
+    int i = (int) (pokolenie - h -> zapisy[0].pokolenie);
+    int j = i;
+    while (!h -> zapisy[j].klatka) {
+        j--;
+    }
+    h -> klatka = h -> zapisy[j].dlugosc;
+    h -> od_klatki = 0;
+    h -> zmiany = i - j;
+    wyczysc_zywe(&(h -> suma));
+    for (int x = j + 1; x <= i; x++) {
+        odczytaj_z_historii(&(h -> zapisy[x]), &(h -> roznica));
+        roznica_symetryczna(&(h -> suma), &(h -> roznica), 
+            &(sym -> bufory.nast));
+        Tzywe temp = h -> suma;
+        h -> suma = sym -> bufory.nast;
+        sym -> bufory.nast = temp;
+        h -> od_klatki += h -> zapisy[x].dlugosc;
+    }
+    odczytaj_z_historii(&(h -> zapisy[j]), &(h -> roznica));
+    roznica_symetryczna(&(h -> roznica), &(h -> suma), &(h -> poprzednia));
+    utnij_historie(h, i + 1);
+    kopiuj_zywe(&(h -> poprzednia), &(sym -> bufory.nast));
+    wstaw_generacje(sym);
+    sym -> cykl.pokolenie = pokolenie;
+    return 1;
+}
+
+/*  Oblicza 'ile' kolejnych generacji symulacji 'sym'. Jeśli jest strumień
+    zmian albo historia, generacje są liczone pojedynczo, a po każdej 
+    zmiany trafiają do strumienia, a generacja do historii. Ujemne 'ile' 
+    nic nie zmienia.  */
+WEWNETRZNA void generacje(Tsymulacja* sym, long long ile) {
+    Thistoria* h = &(sym -> historia);
+    if (ile <= 0) {
+        return;
+    }
+    if (sym -> zmiany.plik == NULL && h -> limit == 0) {
+        generacje_silnika(sym, ile);
+        return;
+    }
+    if (h -> limit > 0 && h -> ile == 0) {
+        zapamietaj_generacje(h, sym -> cykl.pokolenie, biezace_zywe(sym));
+    }
+    for (long long i = 0; i < ile; i++) {
+        generacje_silnika(sym, 1);
+        Tzywe* z = biezace_zywe(sym);
+        if (sym -> zmiany.plik != NULL) {
+            zapisz_zmiany(&(sym -> zmiany), z, sym -> cykl.pokolenie);
+        }
+        if (h -> limit > 0) {
+            zapamietaj_generacje(h, sym -> cykl.pokolenie, z);
+        }
+    }
+    if (sym -> zmiany.plik != NULL) {
+        oproznij(&(sym -> zmiany.pisarz));
+        fflush(sym -> zmiany.plik);
+    }
+}
+
+/*  Wykonuje wczytane z wejścia symulacji 'sym' polecenie powrotu do
+    generacji z historii: 'c N' wraca do generacji 'N', a 'c -N' o 'N' 
+    generacji wstecz.  */
+WEWNETRZNA void polecenie_cofnij(Tsymulacja* sym) {
+    int a;
+    if (!wczytaj_liczbe(&(sym -> czytnik), &a)) {
+        fprintf(stderr, "Brak numeru generacji\n");
+        return;
+    }
+    long long pokolenie = a < 0 ? sym -> cykl.pokolenie + a : a;
+    if (!cofnij(sym, pokolenie)) {
+        fprintf(stderr, "Generacji %lld nie ma w historii\n", pokolenie);
+    }
+}
+
+/*  Zastępuje bieżącą generację symulacji 'sym' migawką z pliku o nazwie 
+    'nazwa' odwzorowanego w pamięci. Wraz z komórkami wczytywany jest numer
+    generacji i okno. Przekazuje 0, jeśli pliku nie da się wczytać, jest 
+    niepoprawny albo zapisano go dla innej reguły (wtedy symulacja się nie
+    zmienia), a w przeciwnym przypadku 1.  */
+WEWNETRZNA int wczytaj_migawke(Tsymulacja* sym, const char* nazwa) {
+    Tczytnik c;
+    if (!otworz_czytnik(&c, nazwa)) {
+        return 0;
+    }
+    const char* b = c.bufor;
+    int poprawna = c.ile >= NAGLOWEK_MIGAWKI 
+        && memcmp(b, ZNACZEK_MIGAWKI, 8) == 0
+        && odczytaj_slowo(b + 8, 4) == WERSJA_MIGAWKI
+        && odczytaj_slowo(b + 12, 4) == (uint64_t) sym -> regula;
+    long long pokolenie = 0;
+    Tokno okno = sym -> okno;
+    if (poprawna) {
+        pokolenie = (long long) odczytaj_slowo(b + 16, 8);
+        okno.w = (int) (int32_t) odczytaj_slowo(b + 24, 4);
+        okno.k = (int) (int32_t) odczytaj_slowo(b + 28, 4);
+        uint64_t wiersze = odczytaj_slowo(b + 32, 8);
+        uint64_t komorki = odczytaj_slowo(b + 40, 8);
+        // Wiersz zajmuje co najmniej trzy bajty, a komórka co najmniej bit.
+        poprawna = pokolenie >= 0 && wiersze <= c.ile / 3 
+                   && komorki <= 8 * (uint64_t) c.ile && komorki <= INT_MAX;
+        if (poprawna) {
+            Tzywe* z = &(sym -> bufory.nast);
+            wyczysc_zywe(z);
+            zarezerwuj(z, (int) wiersze, (int) komorki);
+            c.poz = NAGLOWEK_MIGAWKI;
+            poprawna = wczytaj_wiersze_migawki(&c, z, (int) wiersze, 
+                (int) komorki);
+        }
+    }
+    zwolnij_czytnik(&c);
+    if (!poprawna) {
+        return 0;
+    }
+    wyczysc_historie(&(sym -> historia));
+    wstaw_generacje(sym);
+    sym -> cykl.pokolenie = pokolenie;
+    sym -> okno = okno;
+    return 1;
+}
+
+/*  Pomija odstępy i wczytuje z czytnika 'c' resztę wiersza bez końcowych
+    odstępów jako nazwę pliku do tablicy 'nazwa' o pojemności 
+    'DLUGOSC_NAZWY'. Koniec wiersza zostaje w czytniku. Przekazuje 0, jeśli
+    nazwa jest pusta lub za długa, a w przeciwnym przypadku 1.  */
+WEWNETRZNA int wczytaj_nazwe(Tczytnik* c, char* nazwa) {
+    int znak;
+    while ((znak = podejrzyj(c)) == SPACJA || znak == '\t') {
+        pobierz(c);
+    }
+    size_t n = 0;
+    while ((znak = podejrzyj(c)) != ENTER && znak != EOF) {
+        if (n + 1 == DLUGOSC_NAZWY) {
+            return 0;
+        }
+        nazwa[n++] = (char) pobierz(c);
+    }
+    while (n > 0 && (nazwa[n - 1] == SPACJA || nazwa[n - 1] == '\t' 
+                     || nazwa[n - 1] == '\r')) {
+        n--;
+    }
+    nazwa[n] = '\0';
+    return n > 0;
+}
+
+/*  Wykonuje polecenie zapisania (gdy 'zapis' jest niezerowe) lub 
+    wczytania migawki symulacji 'sym' z plikiem, którego nazwa leży 
+    w czytniku symulacji. Niepowodzenie jest zgłaszane na standardowym 
+    wyjściu błędów.  */
+WEWNETRZNA void polecenie_migawki(Tsymulacja* sym, int zapis) {
+    char nazwa[DLUGOSC_NAZWY];
+    if (!wczytaj_nazwe(&(sym -> czytnik), nazwa)) {
+        fprintf(stderr, "Brak nazwy pliku migawki\n");
+        return;
+    }
+    POCZATEK_POMIARU(t);
+    if (zapis && !zapisz_migawke(sym, nazwa)) {
+        fprintf(stderr, "Nie można zapisać migawki: %s\n", nazwa);
+    }
+    else if (!zapis && !wczytaj_migawke(sym, nazwa)) {
+        fprintf(stderr, "Nie można wczytać migawki: %s\n", nazwa);
+    }
+    KONIEC_POMIARU(sym, FAZA_MIGAWKA, t);
+}
+
+/*  Przekazuje nazwę fazy 'faza' używaną w statystykach.  */
+WEWNETRZNA const char* nazwa_fazy(int faza) {
+    switch (faza) {
+        case FAZA_NOWE_ZYWE: return "nowe_zywe";
+        case FAZA_USTAW: return "ustaw";
+        case FAZA_UMIESC: return "umiesc_zywe";
+        case FAZA_PASMA: return "pasma";
+        case FAZA_BITY: return "bity";
+        case FAZA_HASHLIFE: return "hashlife";
+        case FAZA_OBSZARY: return "obszary";
+        case FAZA_WCZYTANIE: return "wczytanie";
+        case FAZA_OKNO: return "okno";
+        case FAZA_ZRZUT: return "zrzut";
+        case FAZA_MIGAWKA: return "migawka";
+        default: assert(0); // Błąd.
+    }
+    return NULL;
+}
+
+/*  Przekazuje liczbę bajtów zarezerwowanych przez zbiór 'z'.  */
+WEWNETRZNA long long pamiec_zywych(Tzywe* z) {
+    return (long long) (2 * z -> poj_w + 1 + z -> poj_k) 
+           * (long long) sizeof(int);
+}
+
+/*  Zapisuje w '*wysokosc' i '*szerokosc' wymiary najmniejszego 
+    prostokąta zawierającego komórki ze zbioru 'z' (zera dla pustego).  */
+WEWNETRZNA void wymiary_zywych(Tzywe* z, long long* wysokosc, 
+    long long* szerokosc) {
+
+    *wysokosc = 0;
+    *szerokosc = 0;
+    if (z -> ile_w > 0) {
+        int lewa = INT_MAX, prawa = INT_MIN;
+        for (int i = 0; i < z -> ile_w; i++) {
+            lewa = z -> k[z -> pocz[i]] < lewa ? z -> k[z -> pocz[i]] : lewa;
+            prawa = z -> k[z -> pocz[i + 1] - 1] > prawa 
+                    ? z -> k[z -> pocz[i + 1] - 1] : prawa;
+        }
+        *wysokosc = (long long) z -> w[z -> ile_w - 1] - z -> w[0] + 1;
+        *szerokosc = (long long) prawa - lewa + 1;
+    }
+}
+
+/*  Zapisuje w '*wiersze' liczbę niepustych wierszy pasów procesów 
+    roboczych 'r', a w '*wysokosc' i '*szerokosc' wymiary najmniejszego
+    prostokąta zawierającego ich komórki (zera dla pustych pasów). 
+    Wystarczają do tego stany pasów.  */
+WEWNETRZNA void wymiary_procesow(Tprocesy* r, long long* wiersze, 
+    long long* wysokosc, long long* szerokosc) {
+
+    *wiersze = 0;
+    *wysokosc = 0;
+    *szerokosc = 0;
+    int gora = INT_MAX, dol = INT_MIN, lewa = INT_MAX, prawa = INT_MIN;
+    for (int p = 0; p < r -> ile; p++) {
+        Tstan_pasa* s = &(r -> pasy[p]);
+        if (s -> wiersze > 0) {
+            *wiersze += s -> wiersze;
+            gora = s -> pierwszy_w < gora ? s -> pierwszy_w : gora;
+            dol = s -> ostatni_w > dol ? s -> ostatni_w : dol;
+            lewa = s -> lewa_k < lewa ? s -> lewa_k : lewa;
+            prawa = s -> prawa_k > prawa ? s -> prawa_k : prawa;
+        }
+    }
+    if (*wiersze > 0) {
+        *wysokosc = (long long) dol - gora + 1;
+        *szerokosc = (long long) prawa - lewa + 1;
+    }
+}
+
+/*  Wyznacza liczniki opisujące bieżący stan symulacji 'sym'. Nie są one 
+    uaktualniane w trakcie liczenia generacji, tylko liczone na żądanie, 
+    więc nic nie kosztują, dopóki nikt o nie nie pyta.  */
+WEWNETRZNA Tliczniki zbierz_liczniki(Tsymulacja* sym) {
+    Tliczniki l;
+    Tzywe* z = &(sym -> zywe_wiersze);
+    l.pokolenie = sym -> cykl.pokolenie;
+    l.zywe = populacja(sym);
+    // Drzewo HashLife daje prostokąt bez przeglądania komórek, ale liczba
+    // wierszy wymagałaby zrzutu całej generacji.
+    if (sym -> silnik == SILNIK_HASHLIFE) {
+        l.wiersze = -1;
+        hl_wymiary(&(sym -> hl), &l.wysokosc, &l.szerokosc);
+    }
+    else if (sym -> procesy > 0) {
+        wymiary_procesow(&(sym -> robocze), &l.wiersze, &l.wysokosc, 
+            &l.szerokosc);
+    }
+    else {
+        l.wiersze = z -> ile_w;
+        wymiary_zywych(z, &l.wysokosc, &l.szerokosc);
+    }
+    l.bajty = pamiec_zywych(z) + pamiec_zywych(&(sym -> bufory.gora))
+              + pamiec_zywych(&(sym -> bufory.srodek)) 
+              + pamiec_zywych(&(sym -> bufory.dol))
+              + pamiec_zywych(&(sym -> bufory.nast))
+              + pamiec_zywych(&(sym -> cykl.kopia));
+    l.kafelki = 0;
+    if (na_planszy(sym)) {
+        Tplansza* p = &(sym -> plansza);
+        l.kafelki = p -> ile;
+        l.bajty += (long long) p -> ile * (long long) sizeof(Tkafelek)
+                   + (long long) p -> poj * (long long) sizeof(Tkafelek*)
+                   + (long long) (p -> maska + 1) 
+                     * (long long) sizeof(Tmiejsce);
+    }
+    else if (sym -> silnik == SILNIK_OBSZARY) {
+        Tobszary* s = &(sym -> obszary);
+        l.kafelki = s -> ile;
+        l.bajty += (long long) s -> ile * (long long) sizeof(Tobszar)
+                   + (long long) (s -> poj + s -> poj_aktywnych 
+                                  + s -> poj_kandydatow) 
+                     * (long long) sizeof(Tobszar*)
+                   + (long long) (s -> maska + 1) 
+                     * (long long) sizeof(Tmiejsce_obszaru);
+    }
+    else if (sym -> silnik == SILNIK_HASHLIFE) {
+        Thashlife* h = &(sym -> hl);
+        l.bajty += (long long) h -> poj * (long long) sizeof(Twezel)
+                   + (long long) (h -> maska + 1) 
+                     * (long long) sizeof(uint32_t);
+    }
+    l.przydzialy = przydzialy_zywych(sym);
+    return l;
+}
+
+/*  Wypisuje do bufora symulacji 'sym' jej liczniki, a w programie 
+    skompilowanym z opcją -DPOMIARY także czasy faz: łączne i w przeliczeniu
+    na jedną generację.  */
+WEWNETRZNA void wypisz_statystyki(Tsymulacja* sym) {
+    Tpisarz* p = &(sym -> pisarz);
+    Tliczniki l = zbierz_liczniki(sym);
+    wypisz_tekst(p, "generacja:");
+    wypisz_liczbe(p, SPACJA, l.pokolenie);
+    wypisz_tekst(p, "\nżywe:");
+    wypisz_liczbe(p, SPACJA, l.zywe);
+    wypisz_tekst(p, ", wiersze:");
+    if (l.wiersze >= 0) {
+        wypisz_liczbe(p, SPACJA, l.wiersze);
+    }
+    else {
+        wypisz_tekst(p, " nieznane");
+    }
+    wypisz_tekst(p, ", prostokąt:");
+    wypisz_liczbe(p, SPACJA, l.wysokosc);
+    wypisz_tekst(p, " x");
+    wypisz_liczbe(p, SPACJA, l.szerokosc);
+    wypisz_tekst(p, "\nkafelki:");
+    wypisz_liczbe(p, SPACJA, l.kafelki);
+    wypisz_tekst(p, ", pamięć:");
+    wypisz_liczbe(p, SPACJA, l.bajty);
+    wypisz_tekst(p, " B, przydziały:");
+    wypisz_liczbe(p, SPACJA, l.przydzialy);
+    wypisz_znak(p, ENTER);
+    if (sym -> silnik == SILNIK_AUTO) {
+        wypisz_tekst(p, sym -> tryb_bity ? "silnik: bity" : "silnik: lista");
+        wypisz_tekst(p, ", przełączenia:");
+        wypisz_liczbe(p, SPACJA, sym -> przelaczenia);
+        wypisz_znak(p, ENTER);
+    }
+    Thistoria* h = &(sym -> historia);
+    if (h -> ile > 0) {
+        int klatki = 0;
+        for (int i = 0; i < h -> ile; i++) {
+            klatki += h -> zapisy[i].klatka;
+        }
+        wypisz_tekst(p, "historia: generacje");
+        wypisz_liczbe(p, SPACJA, h -> zapisy[0].pokolenie);
+        wypisz_tekst(p, " -");
+        wypisz_liczbe(p, SPACJA, h -> zapisy[h -> ile - 1].pokolenie);
+        wypisz_tekst(p, ", klatki:");
+        wypisz_liczbe(p, SPACJA, klatki);
+        wypisz_tekst(p, ", pamięć:");
+        wypisz_liczbe(p, SPACJA, (long long) h -> bajty);
+        wypisz_tekst(p, " B\n");
+    }
+#ifdef POMIARY
+    for (int f = 0; f < LICZBA_FAZ; f++) {
+        long long ns = sym -> pomiary.ns[f];
+        if (ns == 0) {
+            continue;
+        }
+        wypisz_tekst(p, nazwa_fazy(f));
+        wypisz_znak(p, ':');
+        wypisz_liczbe(p, SPACJA, ns);
+        wypisz_tekst(p, " ns");
+        if (f < FAZA_WCZYTANIE && l.pokolenie > 0) {
+            wypisz_znak(p, ',');
+            wypisz_liczbe(p, SPACJA, ns / l.pokolenie);
+            wypisz_tekst(p, " ns na generację");
+        }
+        wypisz_znak(p, ENTER);
+    }
+#endif
+}
+
+/*  Otwiera plik 'nazwa', do którego trafią pomiary symulacji 'sym', i 
+    zapisuje w nim nagłówek. Pomiary są zapisywane w formacie JSON (jeden 
+    obiekt w wierszu), jeśli nazwa kończy się na ".json", a w przeciwnym 
+    przypadku w formacie CSV. Przekazuje 0, jeśli pliku nie da się 
+    otworzyć, a w przeciwnym przypadku 1.  */
+WEWNETRZNA int otworz_pomiary(Tsymulacja* sym, const char* nazwa) {
+    Tpomiary* m = &(sym -> pomiary);
+    m -> plik = fopen(nazwa, "w");
+    if (m -> plik == NULL) {
+        return 0;
+    }
+    size_t n = strlen(nazwa);
+    m -> json = n >= 5 && strcmp(nazwa + n - 5, ".json") == 0;
+    if (!m -> json) {
+        fprintf(m -> plik, "generacja,generacje,zywe,wiersze,wysokosc,"
+            "szerokosc,kafelki,bajty,przydzialy");
+#ifdef POMIARY
+        for (int f = 0; f < LICZBA_FAZ; f++) {
+            fprintf(m -> plik, ",%s_ns", nazwa_fazy(f));
+        }
+#endif
+        fprintf(m -> plik, "\n");
+    }
+    return 1;
+}
+
+/*  Otwiera plik 'nazwa', do którego trafi strumień zmian symulacji 'sym'.
+    Pierwszy zapis odnosi się do pustej planszy. Przekazuje 0, jeśli pliku
+    nie da się otworzyć, a w przeciwnym przypadku 1.  */
+WEWNETRZNA int otworz_zmiany(Tsymulacja* sym, const char* nazwa) {
+    Tzmiany* m = &(sym -> zmiany);
+    m -> plik = fopen(nazwa, "w");
+    if (m -> plik == NULL) {
+        return 0;
+    }
+    inicjalizuj_pisarza(&(m -> pisarz), m -> plik);
+    inicjalizuj_zywe(&(m -> poprzednia));
+    return 1;
+}
+
+/*  Zapisuje do pliku pomiarów symulacji 'sym' jej liczniki, liczbę 
+    generacji policzonych od poprzedniego zapisu, a w programie 
+    skompilowanym z opcją -DPOMIARY także czasy faz od poprzedniego 
+    zapisu.  */
+WEWNETRZNA void zapisz_pomiar(Tsymulacja* sym) {
+    Tpomiary* m = &(sym -> pomiary);
+    Tliczniki l = zbierz_liczniki(sym);
+    // Nieznana liczba wierszy to null w JSON i puste pole w CSV.
+    char wiersze[24] = "";
+    if (l.wiersze >= 0) {
+        snprintf(wiersze, sizeof(wiersze), "%lld", l.wiersze);
+    }
+    else if (m -> json) {
+        strcpy(wiersze, "null");
+    }
+    const char* format = m -> json 
+        ? "{\"generacja\": %lld, \"generacje\": %lld, \"zywe\": %lld, "
+          "\"wiersze\": %s, \"wysokosc\": %lld, \"szerokosc\": %lld, "
+          "\"kafelki\": %lld, \"bajty\": %lld, \"przydzialy\": %lld"
+        : "%lld,%lld,%lld,%s,%lld,%lld,%lld,%lld,%lld";
+    fprintf(m -> plik, format, l.pokolenie, 
+        l.pokolenie - m -> pokolenie_zapisane, l.zywe, wiersze, 
+        l.wysokosc, l.szerokosc, l.kafelki, l.bajty, l.przydzialy);
+    m -> pokolenie_zapisane = l.pokolenie;
+#ifdef POMIARY
+    for (int f = 0; f < LICZBA_FAZ; f++) {
+        long long ns = m -> ns[f] - m -> ns_zapisane[f];
+        if (m -> json) {
+            fprintf(m -> plik, ", \"%s_ns\": %lld", nazwa_fazy(f), ns);
+        }
+        else {
+            fprintf(m -> plik, ",%lld", ns);
+        }
+        m -> ns_zapisane[f] = m -> ns[f];
+    }
+#endif
+    fprintf(m -> plik, m -> json ? "}\n" : "\n");
+    fflush(m -> plik);
+}
+
+/*  Wczytuje z czytnika 'c' początkową generację symulacji 'sym' w formacie 
+    wierszy ze slashami albo RLE i zastępuje nią bieżącą. Wzór RLE jest 
+    umieszczany w lewym górnym rogu bieżącego okna.  */
+WEWNETRZNA void wczytaj_wzor(Tsymulacja* sym, Tczytnik* c) {
+    POCZATEK_POMIARU(t);
+    if (na_planszy(sym)) {
+        ustaw(&(sym -> plansza), &(sym -> zywe_wiersze), MARTWA);
+    }
+    wyczysc_zywe(&(sym -> zywe_wiersze));
+    wyczysc_cykl(&(sym -> cykl));
+    wyczysc_historie(&(sym -> historia));
+    int znak = podejrzyj(c);
+    while (znak == SPACJA || znak == ENTER || znak == '\t' || znak == '\r') {
+        pobierz(c);
+        znak = podejrzyj(c);
+    }
+    if (znak == SLASH) {
+        wczytaj_generacje(c, &(sym -> zywe_wiersze));
+    }
+    else {
+        wczytaj_rle(c, &(sym -> zywe_wiersze), sym -> okno.w, sym -> okno.k);
+    }
+    if (sym -> silnik == SILNIK_HASHLIFE) {
+        hl_zaladuj(&(sym -> hl), &(sym -> zywe_wiersze));
+    }
+    else if (sym -> silnik == SILNIK_OBSZARY) {
+        zaladuj_obszary(&(sym -> obszary), &(sym -> zywe_wiersze));
+    }
+    else if (na_planszy(sym)) {
+        umiesc_zywe(&(sym -> plansza), &(sym -> zywe_wiersze));
+    }
+    else if (sym -> procesy > 0) {
+        rozdaj_pasy(sym);
+    }
+    KONIEC_POMIARU(sym, FAZA_WCZYTANIE, t);
+}
+
+/*  Kieruje tym, co ma się wydarzyć w programie w zależności od otrzymanego
+    wejścia. Jeśli trzeba wyjść z programu, przekazuje 1, w przeciwnym
+    przypadku przekazuje 0.  */
+WEWNETRZNA int wejscie(Tsymulacja* sym) {
+    Tczytnik* czytnik = &(sym -> czytnik);
+    int pierwszy = podejrzyj(czytnik);
+    switch (pierwszy) {
+        case EOF:
+        case KROPKA: // Zakończ program.
+            return 1;
+            break;
+        case SLASH: // Wczytaj początkową generację.
+        case '#': // Wczytaj początkową generację w formacie RLE.
+        case 'x':
+            wczytaj_wzor(sym, czytnik);
+            break;
+        case ENTER: // Obliczenie kolejnej generacji.
+            generacje(sym, 1);
+            break;
+        case 'o': // Wypisz wykryty okres.
+            pobierz(czytnik);
+            wypisz_okres(&(sym -> pisarz), &(sym -> cykl));
+            break;
+        case 's': // Wypisz statystyki.
+            pobierz(czytnik);
+            wypisz_statystyki(sym);
+            break;
+        case 'c': // Wróć do generacji z historii.
+            pobierz(czytnik);
+            polecenie_cofnij(sym);
+            break;
+        case 'z': // Zapisz migawkę.
+        case 'w': // Wczytaj migawkę.
+            pobierz(czytnik);
+            polecenie_migawki(sym, pierwszy == 'z');
+            break;
+        default:;
+            int a = 0, b = 0;
+            wczytaj_liczbe(czytnik, &a);
+            int c = podejrzyj(czytnik);
+            if (c == SPACJA) { // Przesuwanie okna.
+                wczytaj_liczbe(czytnik, &b);
+                sym -> okno.w = a;
+                sym -> okno.k = b;
+            }
+            else if (c == ENTER) {
+                if (a == 0) { // Zrzut bieżącej generacji.
+                    zrzut_symulacji(sym);
+                }
+                else { // Obliczenie 'a' kolejnych generacji.
+                    generacje(sym, a);
+                }
+            }
+    }
+    return 0;
+}
+
+/*  Przygotowuje symulację 'sym' o już ustawionych opcjach (w tym oknie) 
+    do pracy: pustą generację, silnik i wątki. Standardowe wejście 
+    i wyjście podłącza osobno 'otworz_konsole'.  */
+WEWNETRZNA void inicjalizuj_symulacje(Tsymulacja* sym) {
+    // Inicjalizacja planszy.
+    inicjalizuj_plansze(&(sym -> plansza));
+    // Zbiór wszystkich żywych komórek w bieżącej generacji.
+    inicjalizuj_zywe(&(sym -> zywe_wiersze));
+    // Bufory na kolejne generacje.
+    inicjalizuj_bufory(&(sym -> bufory));
+    inicjalizuj_bity(&(sym -> bity));
+    if (sym -> wysokosc > 0) {
+        ustal_bity(&(sym -> bity), sym -> wysokosc, sym -> szerokosc, 
+            sym -> torus);
+    }
+    inicjalizuj_obszary(&(sym -> obszary));
+    inicjalizuj_cykl(&(sym -> cykl));
+    // Procesy powstają, zanim pojawią się wątki i żywe komórki.
+    if (sym -> procesy > 0) {
+        uruchom_procesy(&(sym -> robocze), sym -> procesy);
+        rozdaj_pasy(sym);
+    }
+    if (sym -> watki > 0) {
+        inicjalizuj_pule(&(sym -> pula), sym -> watki);
+    }
+    if (sym -> silnik == SILNIK_HASHLIFE) {
+        // Na węzeł przypada też jeden kubełek tablicy haszującej.
+        size_t limit = (size_t) sym -> pamiec_hashlife * 1024 * 1024 
+                       / (sizeof(Twezel) + sizeof(uint32_t));
+        inicjalizuj_hashlife(&(sym -> hl), 
+            limit < UINT32_MAX / 2 ? (uint32_t) limit : UINT32_MAX / 2,
+            sym -> regula);
+    }
+    memset(&(sym -> pomiary), 0, sizeof(sym -> pomiary));
+    sym -> pomiary.plik = NULL;
+    sym -> zmiany.plik = NULL;
+    inicjalizuj_historie(&(sym -> historia), 
+        (size_t) sym -> pamiec_historii * 1024 * 1024);
+    sym -> tryb_bity = 0;
+    sym -> przelaczenia = 0;
+}
+
+/*  Podłącza symulację 'sym' do standardowego wejścia, z którego czyta 
+    polecenia, i do standardowego wyjścia, na które wypisuje wyniki. 
+    Symulacje biblioteki i przeglądu zup ich nie używają.  */
+WEWNETRZNA void otworz_konsole(Tsymulacja* sym) {
+    inicjalizuj_czytnik(&(sym -> czytnik), STDIN_FILENO);
+    inicjalizuj_pisarza(&(sym -> pisarz), stdout);
+}
+
+/*  Odłącza symulację 'sym' od standardowego wejścia i wyjścia, wypisując
+    wcześniej to, co zostało w potoku.  */
+WEWNETRZNA void zamknij_konsole(Tsymulacja* sym) {
+    zwolnij_czytnik(&(sym -> czytnik));
+    if (sym -> pisarz.potok != NULL) {
+        oproznij(&(sym -> pisarz));
+        zatrzymaj_potok(&(sym -> potok));
+        sym -> pisarz.potok = NULL;
+    }
+    zwolnij_pisarza(&(sym -> pisarz));
+}
+
+/*  Zwalnia pamięć zarezerwowaną przez symulację 'sym'.  */
+WEWNETRZNA void zwolnij_symulacje(Tsymulacja* sym) {
+    if (sym -> pomiary.plik != NULL) {
+        fclose(sym -> pomiary.plik);
+    }
+    if (sym -> zmiany.plik != NULL) {
+        zwolnij_pisarza(&(sym -> zmiany.pisarz));
+        zwolnij_zywe(&(sym -> zmiany.poprzednia));
+        fclose(sym -> zmiany.plik);
+    }
+    zwolnij_plansze(&(sym -> plansza));
+    if (sym -> watki > 0) {
+        zwolnij_pule(&(sym -> pula));
+    }
+    if (sym -> procesy > 0) {
+        zatrzymaj_procesy(&(sym -> robocze));
+    }
+#ifdef STATYSTYKI_PAMIECI
+    fprintf(stderr, "przydziały pamięci na żywe komórki: %lld\n",
+        przydzialy_zywych(sym));
+#endif
+    zwolnij_zywe(&(sym -> zywe_wiersze));
+    zwolnij_bufory(&(sym -> bufory));
+    zwolnij_bity(&(sym -> bity));
+    zwolnij_obszary(&(sym -> obszary));
+    zwolnij_cykl(&(sym -> cykl));
+    zwolnij_historie(&(sym -> historia));
+    if (sym -> silnik == SILNIK_HASHLIFE) {
+        zwolnij_hashlife(&(sym -> hl));
+    }
+}
+
+/*  Przekazuje nazwę silnika 'silnik' używaną w opcji '--silnik'.  */
+WEWNETRZNA const char* nazwa_silnika(int silnik) {
+    switch (silnik) {
+        case SILNIK_LISTA: return "lista";
+        case SILNIK_BITY: return "bity";
+        case SILNIK_HASHLIFE: return "hashlife";
+        case SILNIK_OBSZARY: return "obszary";
+        case SILNIK_AUTO: return "auto";
+        default: assert(0); // Błąd.
+    }
+    return NULL;
+}
+
+/*  Przekazuje silnik o nazwie 'nazwa' używanej w opcji '--silnik' lub -1, 
+    jeśli takiego silnika nie ma.  */
+WEWNETRZNA int wczytaj_silnik(const char* nazwa) {
+    for (int s = SILNIK_LISTA; s <= SILNIK_AUTO; s++) {
+        if (strcmp(nazwa, nazwa_silnika(s)) == 0) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+/*  Przekazuje maskę reguły zapisanej w postaci 'B3/S23' (wielkość liter
+    nie ma znaczenia, a każda z części może być pusta) lub -1, jeśli zapis 
+    jest niepoprawny.  */
+WEWNETRZNA int wczytaj_regule(const char* tekst) {
+    int regula = 0;
+    const char* czesci = "BS";
+    for (int c = 0; c < 2; c++) {
+        if (toupper((unsigned char) *tekst) != czesci[c]) {
+            return -1;
+        }
+        tekst++;
+        while (*tekst >= '0' && *tekst <= '8') {
+            regula |= 1 << (*tekst - '0' + (c == 0 ? 0 : PRZEZYCIE));
+            tekst++;
+        }
+        if (c == 0 && *(tekst++) != '/') {
+            return -1;
+        }
+    }
+    return *tekst == '\0' ? regula : -1;
+}
+
+/*  Zapisuje w 'tekst' regułę 'regula' w postaci 'B3/S23'. W 'tekst' musi
+    być miejsce na 22 znaki.  */
+WEWNETRZNA void zapisz_regule(int regula, char* tekst) {
+    *(tekst++) = 'B';
+    for (int n = 0; n <= 8; n++) {
+        if (wedlug_reguly(regula, 0, n)) {
+            *(tekst++) = (char) ('0' + n);
+        }
+    }
+    *(tekst++) = '/';
+    *(tekst++) = 'S';
+    for (int n = 0; n <= 8; n++) {
+        if (wedlug_reguly(regula, 1, n)) {
+            *(tekst++) = (char) ('0' + n);
+        }
+    }
+    *tekst = '\0';
+}
+
+/*  Dopisuje do bufora 'p' wzór testowy 't' w formacie RLE albo wierszy 
+    ze slashami. Zupy są losowane funkcją mieszającą, więc każde 
+    uruchomienie daje te same komórki.  */
+WEWNETRZNA void utworz_wzor(Tpisarz* p, const Twzor_testowy* t) {
+    if (t -> rodzaj == WZOR_RLE) {
+        wypisz_tekst(p, t -> rle);
+        return;
+    }
+    Tzywe dzialo;
+    inicjalizuj_zywe(&dzialo);
+    if (t -> rodzaj == WZOR_DZIALA) {
+        Tczytnik c;
+        czytnik_z_tekstu(&c, t -> rle, strlen(t -> rle));
+        wczytaj_rle(&c, &dzialo, 0, 0);
+        // Działa leżą na przekątnej prostopadłej do lotu szybowców, więc
+        // strumienie szybowców biegną obok siebie.
+        for (int i = 0; i < t -> bok; i++) {
+            for (int j = 0; j < dzialo.ile_w; j++) {
+                wypisz_liczbe(p, SLASH, dzialo.w[j] + ODSTEP_DZIAL * i);
+                for (int l = dzialo.pocz[j]; l < dzialo.pocz[j + 1]; l++) {
+                    wypisz_liczbe(p, SPACJA, dzialo.k[l] - ODSTEP_DZIAL * i);
+                }
+                wypisz_znak(p, ENTER);
+            }
+        }
+    }
+    for (int w = 0; t -> rodzaj != WZOR_DZIALA && w < t -> bok; w++) {
+        int pusty = 1;
+        for (int k = 0; k < t -> bok; k++) {
+            int zywa;
+            if (t -> rodzaj == WZOR_BLOKI) {
+                zywa = w % 4 < 2 && k % 4 < 2;
+            }
+            else {
+                uint64_t x = wymieszaj(((uint64_t) w * (uint64_t) t -> bok 
+                                        + (uint64_t) k)
+                                       ^ ((uint64_t) t -> gestosc << 56));
+                zywa = (int) (x % 100) < t -> gestosc;
+            }
+            if (zywa && pusty) {
+                wypisz_liczbe(p, SLASH, w);
+                pusty = 0;
+            }
+            if (zywa) {
+                wypisz_liczbe(p, SPACJA, k);
+            }
+        }
+        if (!pusty) {
+            wypisz_znak(p, ENTER);
+        }
+    }
+    if (t -> rodzaj != WZOR_RLE) {
+        wypisz_znak(p, SLASH);
+        wypisz_znak(p, ENTER);
+    }
+    zwolnij_zywe(&dzialo);
+}
+
+/*  Mierzy wydajność symulacji 'sym' o ustawionych opcjach na wzorze 't'
+    i wypisuje wyniki jako obiekt JSON, poprzedzony przecinkiem, jeśli 
+    'przecinek' jest niezerowe. Generacje są liczone w kilku odcinkach,
+    a liczba przeliczonych komórek jest szacowana na podstawie liczby
+    żywych komórek na początku i końcu każdego odcinka.  */
+WEWNETRZNA void zmierz_wzor(Tsymulacja* sym, const Twzor_testowy* t, 
+    int przecinek) {
+
+    inicjalizuj_symulacje(sym);
+    otworz_konsole(sym);
+    sym -> pisarz.plik = fopen("/dev/null", "w");
+    if (sym -> pisarz.plik == NULL) {
+        fprintf(stderr, "Nie można otworzyć /dev/null\n");
+        exit(1);
+    }
+    Tpisarz tekst;
+    inicjalizuj_pisarza(&tekst, NULL);
+    utworz_wzor(&tekst, t);
+    Tczytnik c;
+    czytnik_z_tekstu(&c, tekst.bufor, tekst.ile);
+    double start = teraz();
+    wczytaj_wzor(sym, &c);
+    double czas_wczytania = teraz() - start;
+    long long zywe = populacja(sym);
+    long long zywe_na_poczatku = zywe;
+    double czas_liczenia = 0, komorki = 0;
+    for (int i = 0; i < ODCINKI_POMIARU; i++) {
+        int ile = (int) ((long long) t -> generacje * (i + 1) / ODCINKI_POMIARU
+                         - (long long) t -> generacje * i / ODCINKI_POMIARU);
+        if (ile == 0) {
+            continue;
+        }
+        start = teraz();
+        generacje(sym, ile);
+        czas_liczenia += teraz() - start;
+        long long nowe = populacja(sym);
+        komorki += (double) (zywe + nowe) / 2 * ile;
+        zywe = nowe;
+    }
+    start = teraz();
+    zrzut_symulacji(sym);
+    wypisz_widok(sym);
+    oproznij(&(sym -> pisarz));
+    double czas_wypisania = teraz() - start;
+    struct rusage zuzycie;
+    getrusage(RUSAGE_SELF, &zuzycie);
+    char regula[22];
+    zapisz_regule(sym -> regula, regula);
+    printf("%s\n  {\"wzor\": \"%s\", \"silnik\": \"%s\", \"regula\": \"%s\", "
+           "\"watki\": %d, \"generacje\": %d, \"zywe_na_poczatku\": %lld, "
+           "\"zywe_na_koncu\": %lld, \"czas_wczytania_s\": %.6f, "
+           "\"czas_liczenia_s\": %.6f, \"czas_wypisania_s\": %.6f, "
+           "\"generacje_na_s\": %.1f, \"komorki_na_s\": %.0f, "
+           "\"maks_rss_kb\": %ld, \"przydzialy\": %lld}",
+        przecinek ? "," : "", t -> nazwa, nazwa_silnika(sym -> silnik), 
+        regula, sym -> watki, t -> generacje, zywe_na_poczatku, zywe, 
+        czas_wczytania, czas_liczenia, czas_wypisania, 
+        czas_liczenia > 0 ? t -> generacje / czas_liczenia : 0,
+        czas_liczenia > 0 ? komorki / czas_liczenia : 0,
+        zuzycie.ru_maxrss, przydzialy_zywych(sym));
+    fflush(stdout);
+    zwolnij_pisarza(&tekst);
+    fclose(sym -> pisarz.plik);
+    sym -> pisarz.plik = NULL;
+    zamknij_konsole(sym);
+    zwolnij_symulacje(sym);
+}
+
+/*  Przepuszcza przez silnik symulacji 'sym' stały zestaw wzorów, których 
+    nazwy zaczynają się od 'sym -> wydajnosc', i wypisuje wyniki pomiarów 
+    jako tablicę JSON. Każdy wzór jest liczony w osobnym procesie, aby
+    szczytowe zużycie pamięci dotyczyło tylko niego. Przekazuje kod 
+    wyjścia programu.  */
+WEWNETRZNA int test_wydajnosci(Tsymulacja* sym) {
+    const char* dzialo = "x = 36, y = 9\n24bo$22bobo$12b2o6b2o12b2o$11bo3bo4b"
+        "2o12b2o$2o8bo5bo3b2o$2o8bo3bob2o4bobo$10bo5bo7bo$11bo3bo$12b2o!\n";
+    const Twzor_testowy zestaw[] = {
+        {"r-pentomino", WZOR_RLE, "x = 3, y = 3\nb2o$2o$bo!\n", 0, 0, 1000},
+        {"zoledz", WZOR_RLE, "x = 7, y = 3\nbo$3bo$2o2b3o!\n", 0, 0, 5000},
+        {"dzialo-gospera", WZOR_RLE, dzialo, 0, 0, 1000},
+        {"rzad-dzial", WZOR_DZIALA, dzialo, 32, 0, 1000},
+        {"zupa-64-20", WZOR_ZUPA, NULL, 64, 20, 1000},
+        {"zupa-64-35", WZOR_ZUPA, NULL, 64, 35, 1000},
+        {"zupa-64-50", WZOR_ZUPA, NULL, 64, 50, 1000},
+        {"zupa-512-20", WZOR_ZUPA, NULL, 512, 20, 200},
+        {"zupa-512-35", WZOR_ZUPA, NULL, 512, 35, 200},
+        {"zupa-512-50", WZOR_ZUPA, NULL, 512, 50, 200},
+        {"zupa-2048-20", WZOR_ZUPA, NULL, 2048, 20, 20},
+        {"zupa-2048-35", WZOR_ZUPA, NULL, 2048, 35, 20},
+        {"zupa-2048-50", WZOR_ZUPA, NULL, 2048, 50, 20},
+        {"zupa-8192-20", WZOR_ZUPA, NULL, 8192, 20, 2},
+        {"zupa-8192-35", WZOR_ZUPA, NULL, 8192, 35, 2},
+        {"zupa-8192-50", WZOR_ZUPA, NULL, 8192, 50, 2},
+        {"pole-blokow-2048", WZOR_BLOKI, NULL, 2048, 0, 100}
+    };
+    int ile = (int) (sizeof(zestaw) / sizeof(zestaw[0]));
+    size_t dlugosc = strlen(sym -> wydajnosc);
+    int wypisane = 0;
+    printf("[");
+    for (int i = 0; i < ile; i++) {
+        if (strncmp(zestaw[i].nazwa, sym -> wydajnosc, dlugosc) != 0) {
+            continue;
+        }
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+            zmierz_wzor(sym, &zestaw[i], wypisane > 0);
+            exit(0);
+        }
+        int stan;
+        if (pid < 0 || waitpid(pid, &stan, 0) != pid || !WIFEXITED(stan) 
+            || WEXITSTATUS(stan) != 0) {
+            fprintf(stderr, "Pomiar wzoru %s nie powiódł się\n", 
+                zestaw[i].nazwa);
+            return 1;
+        }
+        wypisane++;
+    }
+    printf("\n]\n");
+    return 0;
+}
+
+/*  Wypisuje do bufora symulacji 'sym' wynik trybu wsadowego wybrany 
+    opcją '--wyjscie' i opróżnia bufor.  */
+WEWNETRZNA void wypisz_wynik(Tsymulacja* sym) {
+    switch (sym -> wyjscie) {
+        case WYJSCIE_ZRZUT:
+            zrzut_symulacji(sym);
+            break;
+        case WYJSCIE_OKNO:
+            wypisz_widok(sym);
+            break;
+        case WYJSCIE_STATYSTYKI:
+            wypisz_statystyki(sym);
+            break;
+        default: assert(0); // Błąd.
+    }
+    oproznij(&(sym -> pisarz));
+}
+
+/*  Liczy w trybie wsadowym 'sym -> wsadowo' generacji wczytanego już wzoru
+    bez wypisywania okna po drodze. Wynik jest wypisywany na końcu, 
+    a jeśli 'sym -> co' jest dodatnie, także co tyle generacji. Pomiary 
+    trafiają do pliku po każdej porcji generacji.  */
+WEWNETRZNA void praca_wsadowa(Tsymulacja* sym) {
+    long long zrobione = 0;
+    while (zrobione < sym -> wsadowo) {
+        long long ile = sym -> wsadowo - zrobione;
+        if (sym -> co > 0 && sym -> co < ile) {
+            ile = sym -> co;
+        }
+        generacje(sym, ile);
+        zrobione += ile;
+        if (sym -> pomiary.plik != NULL) {
+            zapisz_pomiar(sym);
+        }
+        if (zrobione < sym -> wsadowo) {
+            wypisz_wynik(sym);
+        }
+    }
+    wypisz_wynik(sym);
+}
+
+/*  Zapisuje w pustym zbiorze 'z' losową zupę o boku 'bok' z lewym górnym
+    rogiem w wierszu 0 i kolumnie 0, w której żywy jest mniej więcej 
+    odsetek 'gestosc' komórek. Ta sama liczba 'ziarno' daje tę samą zupę.  */
+WEWNETRZNA void losuj_zupe(Tzywe* z, uint64_t ziarno, int bok, int gestosc) {
+    int n = 0;
+    for (int w = 0; w < bok; w++) {
+        zarezerwuj(z, z -> ile_w + 1, n + bok);
+        z -> w[z -> ile_w] = w;
+        for (int k = 0; k < bok; k++) {
+            uint64_t x = wymieszaj((ziarno << 32) 
+                                   + (uint64_t) w * (uint64_t) bok 
+                                   + (uint64_t) k);
+            if ((int) (x % 100) < gestosc) {
+                z -> k[n++] = k;
+            }
+        }
+        zakoncz_wiersz(z, n);
+    }
+}
+
+/*  Przekazuje w '*nr' numer kolejnej zupy do policzenia przez wątek 'nr'
+    przeglądu 'p'. Gdy jego zakres jest pusty, zabiera drugą połowę 
+    zakresu pierwszego wątku, który jeszcze ma zupy. Przekazuje 0, jeśli 
+    wszystkie zupy są już rozdane, a w przeciwnym przypadku 1.  */
+WEWNETRZNA int wez_zupe(Tprzeglad* p, int nr, long long* zupa) {
+    Tkolejka_zup* moja = &(p -> kolejki[nr]);
+    pthread_mutex_lock(&(moja -> zamek));
+    if (moja -> od < moja -> do_) {
+        *zupa = moja -> od++;
+        pthread_mutex_unlock(&(moja -> zamek));
+        return 1;
+    }
+    pthread_mutex_unlock(&(moja -> zamek));
+    for (int i = 1; i < p -> ile_watkow; i++) {
+        Tkolejka_zup* cudza = &(p -> kolejki[(nr + i) % p -> ile_watkow]);
+        pthread_mutex_lock(&(cudza -> zamek));
+        long long od = cudza -> do_ - (cudza -> do_ - cudza -> od + 1) / 2;
+        long long do_ = cudza -> do_;
+        cudza -> do_ = od;
+        pthread_mutex_unlock(&(cudza -> zamek));
+        if (od < do_) {
+            pthread_mutex_lock(&(moja -> zamek));
+            moja -> od = od + 1;
+            moja -> do_ = do_;
+            pthread_mutex_unlock(&(moja -> zamek));
+            pthread_mutex_lock(&(p -> zamek_kradziezy));
+            p -> kradziezy++;
+            pthread_mutex_unlock(&(p -> zamek_kradziezy));
+            *zupa = od;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*  Wątek przeglądu zup: liczy zupy własną symulacją z opcjami przeglądu,
+    dopóki jakieś zostały, i zapisuje ich wyniki.  */
+WEWNETRZNA void* licz_zupy(void* dane) {
+    Tliczacy_zupy* l = (Tliczacy_zupy*) dane;
+    Tprzeglad* p = l -> przeglad;
+    Tsymulacja sym = *(p -> opcje);
+    sym.watki = 0;
+    sym.procesy = 0;
+    sym.plik_pomiarow = NULL;
+    inicjalizuj_symulacje(&sym);
+    long long zupa;
+    while (wez_zupe(p, l -> nr, &zupa)) {
+        wyczysc_zywe(&(sym.bufory.nast));
+        losuj_zupe(&(sym.bufory.nast), (uint64_t) (sym.ziarno + zupa), 
+            sym.bok_zupy, sym.gestosc_zupy);
+        wstaw_generacje(&sym);
+        generacje(&sym, sym.wsadowo);
+        Tzywe* z = &(sym.zywe_wiersze);
+        if (sym.silnik == SILNIK_HASHLIFE) {
+            z = &(sym.bufory.nast);
+            hl_zapisz(&(sym.hl), z);
+        }
+        Twynik_zupy* w = &(p -> wyniki[zupa]);
+        w -> zywe = ile_zywych(z);
+        wymiary_zywych(z, &(w -> wysokosc), &(w -> szerokosc));
+        w -> okres = sym.cykl.okres;
+        w -> dw = sym.cykl.dw;
+        w -> dk = sym.cykl.dk;
+    }
+    zwolnij_symulacje(&sym);
+    return NULL;
+}
+
+/*  Liczy 'opcje -> zupy' losowych zup po 'opcje -> wsadowo' generacji 
+    w 'opcje -> watki' wątkach (co najmniej jednym), z których każdy ma 
+    własną symulację. Zupy są rozdzielane między wątki po równo, 
+    a nierówności kosztu wyrównuje zabieranie pracy. Wyniki są wypisywane 
+    na standardowe wyjście w formacie CSV, wiersz na zupę, w kolejności 
+    numerów zup, a podsumowanie na standardowe wyjście błędów.  */
+WEWNETRZNA int przeglad_zup(Tsymulacja* opcje) {
+    double start = teraz();
+    Tprzeglad p;
+    p.opcje = opcje;
+    p.ile_watkow = opcje -> watki > 0 ? opcje -> watki : 1;
+    p.kradziezy = 0;
+    p.kolejki = (Tkolejka_zup*) malloc((size_t) p.ile_watkow 
+                                       * sizeof(Tkolejka_zup));
+    p.wyniki = (Twynik_zupy*) malloc((size_t) opcje -> zupy 
+                                     * sizeof(Twynik_zupy));
+    Tliczacy_zupy* liczacy = (Tliczacy_zupy*) malloc((size_t) p.ile_watkow 
+                                                     * sizeof(Tliczacy_zupy));
+    pthread_t* watki = (pthread_t*) malloc((size_t) p.ile_watkow 
+                                           * sizeof(pthread_t));
+    assert(p.kolejki != NULL && p.wyniki != NULL && liczacy != NULL 
+           && watki != NULL);
+    pthread_mutex_init(&(p.zamek_kradziezy), NULL);
+    for (int i = 0; i < p.ile_watkow; i++) {
+        pthread_mutex_init(&(p.kolejki[i].zamek), NULL);
+        p.kolejki[i].od = opcje -> zupy * i / p.ile_watkow;
+        p.kolejki[i].do_ = opcje -> zupy * (i + 1) / p.ile_watkow;
+        liczacy[i].przeglad = &p;
+        liczacy[i].nr = i;
+    }
+    // Wątek główny liczy zupy z zakresu zerowego.
+    for (int i = 1; i < p.ile_watkow; i++) {
+        int blad = pthread_create(&(watki[i]), NULL, licz_zupy, &liczacy[i]);
+        assert(blad == 0);
+        (void) blad;
+    }
+    licz_zupy(&liczacy[0]);
+    for (int i = 1; i < p.ile_watkow; i++) {
+        pthread_join(watki[i], NULL);
+    }
+    Tpisarz wyjscie;
+    inicjalizuj_pisarza(&wyjscie, stdout);
+    wypisz_tekst(&wyjscie, "zupa,zywe,okres,dw,dk,wysokosc,szerokosc");
+    for (long long i = 0; i < opcje -> zupy; i++) {
+        Twynik_zupy* w = &(p.wyniki[i]);
+        wypisz_liczbe(&wyjscie, ENTER, opcje -> ziarno + i);
+        wypisz_liczbe(&wyjscie, ',', w -> zywe);
+        wypisz_liczbe(&wyjscie, ',', w -> okres);
+        wypisz_liczbe(&wyjscie, ',', w -> dw);
+        wypisz_liczbe(&wyjscie, ',', w -> dk);
+        wypisz_liczbe(&wyjscie, ',', w -> wysokosc);
+        wypisz_liczbe(&wyjscie, ',', w -> szerokosc);
+    }
+    wypisz_znak(&wyjscie, ENTER);
+    zwolnij_pisarza(&wyjscie);
+    double czas = teraz() - start;
+    fprintf(stderr, "zupy: %lld, wątki: %d, czas: %.3f s, zupy na s: %.1f, "
+            "kradzieże: %lld\n", opcje -> zupy, p.ile_watkow, czas, 
+            czas > 0 ? (double) opcje -> zupy / czas : 0, p.kradziezy);
+    for (int i = 0; i < p.ile_watkow; i++) {
+        pthread_mutex_destroy(&(p.kolejki[i].zamek));
+    }
+    pthread_mutex_destroy(&(p.zamek_kradziezy));
+    free(p.kolejki);
+    free(p.wyniki);
+    free(liczacy);
+    free(watki);
+    return 0;
+}
+
+/*  Wczytuje do '*x' nieujemną liczbę zapisaną w całym napisie 'tekst'. 
+    Przekazuje 0, jeśli napis nie jest taką liczbą, a w przeciwnym 
+    przypadku 1.  */
+WEWNETRZNA int liczba_opcji(const char* tekst, long long* x) {
+    char* koniec;
+    errno = 0;
+    *x = strtoll(tekst, &koniec, 10);
+    return *tekst >= '0' && *tekst <= '9' && *koniec == '\0' && errno == 0;
+}
+
+/*  Ustawia opcje symulacji 'sym' na podstawie argumentów wywołania. Przy 
+    nieznanej opcji wypisuje komunikat i kończy program.  */
+WEWNETRZNA void wczytaj_opcje(int argc, char* argv[], Tsymulacja* sym) {
+    long long x;
+    int w, k;
+    char znak;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--silnik=", 9) == 0 
+            && wczytaj_silnik(argv[i] + 9) >= 0) {
+            sym -> silnik = wczytaj_silnik(argv[i] + 9);
+        }
+        else if (strcmp(argv[i], "--wydajnosc") == 0) {
+            sym -> wydajnosc = "";
+        }
+        else if (strncmp(argv[i], "--wydajnosc=", 12) == 0) {
+            sym -> wydajnosc = argv[i] + 12;
+        }
+        else if (strncmp(argv[i], "--pomiary=", 10) == 0) {
+            sym -> plik_pomiarow = argv[i] + 10;
+        }
+        else if (strncmp(argv[i], "--zmiany=", 9) == 0) {
+            sym -> plik_zmian = argv[i] + 9;
+        }
+        else if (strcmp(argv[i], "--potok") == 0) {
+            sym -> potokowo = 1;
+        }
+        else if (strncmp(argv[i], "--historia=", 11) == 0 
+                 && atoi(argv[i] + 11) > 0) {
+            sym -> pamiec_historii = atoi(argv[i] + 11);
+        }
+        else if (strncmp(argv[i], "--regula=", 9) == 0
+                 && wczytaj_regule(argv[i] + 9) >= 0) {
+            sym -> regula = wczytaj_regule(argv[i] + 9);
+            if (wedlug_reguly(sym -> regula, 0, 0)) {
+                // Przy B0 martwa nieskończoność ożywałaby co generację.
+                fprintf(stderr, "Reguły z B0 nie są obsługiwane: %s\n", 
+                    argv[i] + 9);
+                exit(1);
+            }
+        }
+        else if (strncmp(argv[i], "--wsadowo=", 10) == 0 
+                 && liczba_opcji(argv[i] + 10, &x)) {
+            sym -> wsadowo = x;
+        }
+        else if (strncmp(argv[i], "--co=", 5) == 0 
+                 && liczba_opcji(argv[i] + 5, &x) && x > 0) {
+            sym -> co = x;
+        }
+        else if (strcmp(argv[i], "--wyjscie=zrzut") == 0) {
+            sym -> wyjscie = WYJSCIE_ZRZUT;
+        }
+        else if (strcmp(argv[i], "--wyjscie=okno") == 0) {
+            sym -> wyjscie = WYJSCIE_OKNO;
+        }
+        else if (strcmp(argv[i], "--wyjscie=statystyki") == 0) {
+            sym -> wyjscie = WYJSCIE_STATYSTYKI;
+        }
+        else if (strncmp(argv[i], "--okno=", 7) == 0 
+                 && sscanf(argv[i] + 7, "%d,%d%c", &w, &k, &znak) == 2) {
+            sym -> okno.w = w;
+            sym -> okno.k = k;
+        }
+        else if (strncmp(argv[i], "--zupy=", 7) == 0 
+                 && liczba_opcji(argv[i] + 7, &x) && x > 0) {
+            sym -> zupy = x;
+        }
+        else if (strncmp(argv[i], "--ziarno=", 9) == 0 
+                 && liczba_opcji(argv[i] + 9, &x) && x < INT_MAX) {
+            sym -> ziarno = x;
+        }
+        else if (strncmp(argv[i], "--bok-zupy=", 11) == 0 
+                 && liczba_opcji(argv[i] + 11, &x) && x > 0 && x <= 1 << 20) {
+            sym -> bok_zupy = (int) x;
+        }
+        else if (strncmp(argv[i], "--gestosc-zupy=", 15) == 0 
+                 && liczba_opcji(argv[i] + 15, &x) && x <= 100) {
+            sym -> gestosc_zupy = (int) x;
+        }
+        else if ((strncmp(argv[i], "--torus=", 8) == 0 
+                  || strncmp(argv[i], "--plansza=", 10) == 0)
+                 && sscanf(strchr(argv[i], '=') + 1, "%dx%d%c", &w, &k, 
+                           &znak) == 2
+                 && w > 0 && k > 0 && w < INT_MAX - 2 && k < INT_MAX - 128) {
+            sym -> wysokosc = w;
+            sym -> szerokosc = k;
+            sym -> torus = argv[i][2] == 't';
+        }
+        else if (strncmp(argv[i], "--wzor=", 7) == 0) {
+            sym -> wzor = argv[i] + 7;
+        }
+        else if (strncmp(argv[i], "--watki=", 8) == 0 
+                 && atoi(argv[i] + 8) > 0) {
+            sym -> watki = atoi(argv[i] + 8);
+        }
+        else if (strncmp(argv[i], "--procesy=", 10) == 0 
+                 && atoi(argv[i] + 10) > 0) {
+            sym -> procesy = atoi(argv[i] + 10);
+        }
+        else if (strncmp(argv[i], "--pamiec-hashlife=", 18) == 0 
+                 && atoi(argv[i] + 18) > 0) {
+            sym -> pamiec_hashlife = atoi(argv[i] + 18);
+        }
+        else {
+            fprintf(stderr, "Nieznana opcja: %s\n", argv[i]);
+            exit(1);
+        }
+    }
+}
+
+/*  Ustawia domyślne opcje symulacji 'sym': silnik listowy liczący na 
+    planszy według reguły Conwaya i okno zaczynające się w wierszu 1
+    i kolumnie 1.  */
+WEWNETRZNA void domyslne_opcje(Tsymulacja* sym) {
+    sym -> silnik = SILNIK_LISTA;
+    sym -> pamiec_hashlife = PAMIEC_HASHLIFE;
+    sym -> regula = REGULA_CONWAY;
+    sym -> watki = 0;
+    sym -> procesy = 0;
+    sym -> wzor = NULL;
+    sym -> wydajnosc = NULL;
+    sym -> plik_pomiarow = NULL;
+    sym -> plik_zmian = NULL;
+    sym -> pamiec_historii = 0;
+    sym -> potokowo = 0;
+    sym -> okno.w = 1;
+    sym -> okno.k = 1;
+    sym -> wsadowo = -1;
+    sym -> co = 0;
+    sym -> wyjscie = WYJSCIE_ZRZUT;
+    sym -> zupy = 0;
+    sym -> ziarno = 1;
+    sym -> bok_zupy = BOK_ZUPY;
+    sym -> gestosc_zupy = GESTOSC_ZUPY;
+    sym -> wysokosc = 0;
+    sym -> szerokosc = 0;
+    sym -> torus = 0;
+}
+
+// Funkcje interfejsu dla innych programów są opisane w pliku zycie.h.
+
+Tsymulacja* zycie_utworz(const char* silnik, const char* regula, int watki) {
+    int s = silnik == NULL ? SILNIK_LISTA : wczytaj_silnik(silnik);
+    int r = regula == NULL ? REGULA_CONWAY : wczytaj_regule(regula);
+    if (s < 0 || r < 0 || wedlug_reguly(r, 0, 0) || watki < 0) {
+        return NULL;
+    }
+    Tsymulacja* sym = (Tsymulacja*) malloc(sizeof(Tsymulacja));
+    assert(sym != NULL);
+    domyslne_opcje(sym);
+    sym -> silnik = s;
+    sym -> regula = r;
+    sym -> watki = watki;
+    inicjalizuj_symulacje(sym);
+    return sym;
+}
+
+void zycie_wstaw(Tsymulacja* sym, const int* w, const int* k, int ile) {
+    Tzywe* z = &(sym -> bufory.nast);
+    wyczysc_zywe(z);
+    zarezerwuj(z, ile + 1, ile);
+    int posortowane = 1; // Czy dotąd wszystko było rosnąco.
+    for (int i = 0; i < ile; i++) {
+        if (i > 0 && w[i] != w[i - 1]) {
+            zakoncz_wiersz(z, i);
+            posortowane = posortowane && w[i] > w[i - 1];
+        }
+        else if (i > 0 && k[i] <= k[i - 1]) {
+            posortowane = 0;
+        }
+        z -> w[z -> ile_w] = w[i];
+        z -> k[i] = k[i];
+    }
+    zakoncz_wiersz(z, ile);
+    if (!posortowane) {
+        uporzadkuj_zywe(z);
+    }
+    wyczysc_historie(&(sym -> historia));
+    wstaw_generacje(sym);
+}
+
+void zycie_licz(Tsymulacja* sym, long long ile) {
+    generacje(sym, ile);
+}
+
+long long zycie_populacja(Tsymulacja* sym) {
+    return populacja(sym);
+}
+
+long long zycie_pokolenie(Tsymulacja* sym) {
+    return sym -> cykl.pokolenie;
+}
+
+long long zycie_prostokat(Tsymulacja* sym, int w1, int k1, int w2, int k2,
+    Tfragment f, void* dane) {
+
+    Tzywe* z = &(sym -> zywe_wiersze);
+    if (sym -> silnik == SILNIK_HASHLIFE) {
+        // Drzewo jest przechodzone tylko w obrębie prostokąta.
+        Tprostokat r = { w1, k1, w2, k2 };
+        z = &(sym -> bufory.nast);
+        wyczysc_zywe(z);
+        hl_prostokat(&(sym -> hl), sym -> hl.korzen, 
+            sym -> hl.wezly[sym -> hl.korzen].poziom, sym -> hl.min_w, 
+            sym -> hl.min_k, r, z);
+        uporzadkuj_zywe(z);
+    }
+    long long wynik = 0;
+    for (int i = pierwszy_niemniejszy(z -> w, 0, z -> ile_w, w1); 
+         i < z -> ile_w && z -> w[i] <= w2; i++) {
+        int j = pierwszy_niemniejszy(z -> k, z -> pocz[i], z -> pocz[i + 1], 
+                                     k1);
+        int koniec = k2 == INT_MAX ? z -> pocz[i + 1] 
+            : pierwszy_niemniejszy(z -> k, j, z -> pocz[i + 1], k2 + 1);
+        if (koniec > j && f != NULL) {
+            f(dane, z -> w[i], z -> k + j, koniec - j);
+        }
+        wynik += koniec - j;
+    }
+    return wynik;
+}
+
+void zycie_zniszcz(Tsymulacja* sym) {
+    zwolnij_symulacje(sym);
+    free(sym);
+}
+
+#ifndef ZYCIE_BIBLIOTEKA
+int main(int argc, char* argv[]) {
+    Tsymulacja sym;
+    domyslne_opcje(&sym);
+    wczytaj_opcje(argc, argv, &sym);
+    if (sym.wysokosc > 0 && sym.silnik == SILNIK_LISTA) {
+        sym.silnik = SILNIK_BITY;
+    }
+    else if (sym.wysokosc > 0 && sym.silnik != SILNIK_BITY) {
+        fprintf(stderr, "Plansza o stałych wymiarach wymaga silnika "
+            "bitowego\n");
+        exit(1);
+    }
+    if (sym.procesy > 0 && sym.silnik != SILNIK_LISTA) {
+        fprintf(stderr, "Liczenie w procesach wymaga silnika listowego\n");
+        exit(1);
+    }
+    if (sym.wydajnosc != NULL) {
+        return test_wydajnosci(&sym);
+    }
+    if (sym.zupy > 0) {
+        if (sym.wsadowo < 0) {
+            sym.wsadowo = GENERACJE_ZUPY;
+        }
+        return przeglad_zup(&sym);
+    }
+    inicjalizuj_symulacje(&sym);
+    otworz_konsole(&sym);
+    if (sym.plik_pomiarow != NULL && !otworz_pomiary(&sym, sym.plik_pomiarow)) {
+        fprintf(stderr, "Nie można utworzyć pliku: %s\n", sym.plik_pomiarow);
+        exit(1);
+    }
+    if (sym.plik_zmian != NULL && !otworz_zmiany(&sym, sym.plik_zmian)) {
+        fprintf(stderr, "Nie można utworzyć pliku: %s\n", sym.plik_zmian);
+        exit(1);
+    }
+    if (sym.potokowo) {
+        uruchom_potok(&(sym.potok), &(sym.pisarz));
+    }
+    if (sym.wzor != NULL) {
+        Tczytnik plik;
+        if (!otworz_czytnik(&plik, sym.wzor)) {
+            fprintf(stderr, "Nie można wczytać pliku: %s\n", sym.wzor);
+            exit(1);
+        }
+        wczytaj_wzor(&sym, &plik);
+        zwolnij_czytnik(&plik);
+    }
+    if (sym.wsadowo >= 0) {
+        if (sym.wzor == NULL) {
+            wczytaj_wzor(&sym, &(sym.czytnik));
+        }
+        praca_wsadowa(&sym);
+        zamknij_konsole(&sym);
+        zwolnij_symulacje(&sym);
+        return 0;
+    }
+    // Główna pętla programu.
+    while (!wejscie(&sym)) {
+        wypisz_widok(&sym);
+        oproznij(&(sym.pisarz));
+        if (sym.pisarz.potok == NULL) {
+            // Potok sam opróżnia plik, gdy nadąża z wypisywaniem.
+            fflush(stdout);
+        }
+        if (sym.pomiary.plik != NULL) {
+            zapisz_pomiar(&sym);
+        }
+        wyczysc_strumien(&(sym.czytnik));
+    }
+    // Zwalnianie pamięci.
+    zamknij_konsole(&sym);
+    zwolnij_symulacje(&sym);
+    return 0;
+}
+#endif
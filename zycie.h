@@ -0,0 +1,56 @@
+/*  Interfejs silnika gry w życie do osadzania w innych programach.
+Symulację tworzy się, zasila komórkami i odpytuje bezpośrednio, bez
+wypisywania i wczytywania tekstu. Biblioteka to plik zycie.c skompilowany
+z opcją -DZYCIE_BIBLIOTEKA, np.
+
+    gcc -O2 -pthread -DZYCIE_BIBLIOTEKA -c zycie.c
+
+Autor: Michał Mnich  */
+
+#ifndef ZYCIE_H
+#define ZYCIE_H
+
+/*  Symulacja. Jej zawartość jest znana tylko silnikowi.  */
+typedef struct symulacja Tsymulacja;
+
+/*  Funkcja przekazująca wywołującemu fragment wiersza 'w' z żywymi
+    komórkami: 'ile' rosnących kolumn z tablicy 'k', która należy do
+    silnika i jest ważna tylko do powrotu z funkcji. 'dane' to wskaźnik
+    przekazany przy zapytaniu.  */
+typedef void (*Tfragment)(void* dane, int w, const int* k, int ile);
+
+/*  Tworzy pustą symulację liczoną silnikiem o nazwie 'silnik' (jak
+    w opcji '--silnik', NULL to silnik listowy) według reguły 'regula'
+    zapisanej jak 'B3/S23' (NULL to reguła Conwaya) w 'watki' wątkach
+    (0 to liczenie na planszy). Przekazuje NULL, jeśli silnik albo reguła
+    są nieznane lub reguła zawiera B0.  */
+Tsymulacja* zycie_utworz(const char* silnik, const char* regula, int watki);
+
+/*  Zastępuje bieżącą generację symulacji 'sym' komórkami o wierszach
+    'w[i]' i kolumnach 'k[i]' dla 'i' od 0 do 'ile' - 1. Komórki mogą być
+    w dowolnej kolejności i mogą się powtarzać, ale uporządkowane wierszami,
+    a w wierszu kolumnami, są wstawiane bez sortowania. Licznik generacji
+    jest zerowany.  */
+void zycie_wstaw(Tsymulacja* sym, const int* w, const int* k, int ile);
+
+/*  Oblicza 'ile' kolejnych generacji symulacji 'sym'.  */
+void zycie_licz(Tsymulacja* sym, long long ile);
+
+/*  Przekazuje liczbę żywych komórek bieżącej generacji symulacji 'sym'.  */
+long long zycie_populacja(Tsymulacja* sym);
+
+/*  Przekazuje numer bieżącej generacji symulacji 'sym'.  */
+long long zycie_pokolenie(Tsymulacja* sym);
+
+/*  Przekazuje funkcji 'f' z wskaźnikiem 'dane' kolejne wiersze żywych
+    komórek bieżącej generacji symulacji 'sym' leżących w prostokącie od
+    wiersza 'w1' i kolumny 'k1' do wiersza 'w2' i kolumny 'k2' włącznie,
+    rosnąco. 'f' może być NULL, jeśli potrzebna jest tylko liczba komórek.
+    Przekazuje liczbę komórek w prostokącie.  */
+long long zycie_prostokat(Tsymulacja* sym, int w1, int k1, int w2, int k2,
+    Tfragment f, void* dane);
+
+/*  Zwalnia symulację 'sym' utworzoną przez 'zycie_utworz'.  */
+void zycie_zniszcz(Tsymulacja* sym);
+
+#endif